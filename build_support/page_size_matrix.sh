@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+
+## =================================================================
+## PAGE SIZE MATRIX
+##
+## Builds BusTub once for every page size and runs either the test
+## suite or the storage benchmarks of each build, so that layouts
+## derived from BUSTUB_PAGE_SIZE are checked at more than one size.
+##
+## Usage: page_size_matrix.sh <test|bench> <source dir> <build dir> [page sizes...]
+##
+## Every page size is built in <build dir>/page_size_<bytes>. Tests
+## run in Debug (with sanitizers) and benchmarks in Release.
+## =================================================================
+
+set -euo pipefail
+
+if [ $# -lt 3 ]; then
+  echo "Usage: $0 <test|bench> <source dir> <build dir> [page sizes...]" >&2
+  exit 1
+fi
+
+MODE=$1
+SOURCE_DIR=$2
+BUILD_ROOT=$3
+shift 3
+PAGE_SIZES=("$@")
+if [ ${#PAGE_SIZES[@]} -eq 0 ]; then
+  PAGE_SIZES=(4096 16384 65536)
+fi
+JOBS=$(nproc 2>/dev/null || sysctl -n hw.ncpu)
+
+for PAGE_SIZE in "${PAGE_SIZES[@]}"; do
+  BUILD_DIR="$BUILD_ROOT/page_size_$PAGE_SIZE"
+  echo "=== page size $PAGE_SIZE ($MODE) ==="
+  case $MODE in
+    test)
+      cmake -S "$SOURCE_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Debug -DBUSTUB_PAGE_SIZE="$PAGE_SIZE" > /dev/null
+      cmake --build "$BUILD_DIR" --target build-tests -j "$JOBS"
+      (cd "$BUILD_DIR" && ctest -j "$JOBS" --output-on-failure -E "SQLLogicTest|Trie|BPlusTreeContentionTest")
+      ;;
+    bench)
+      cmake -S "$SOURCE_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release -DBUSTUB_PAGE_SIZE="$PAGE_SIZE" > /dev/null
+      cmake --build "$BUILD_DIR" --target btree-bench -j "$JOBS"
+      cmake --build "$BUILD_DIR" --target bpm-bench -j "$JOBS"
+      "$BUILD_DIR/bin/bustub-btree-bench" --duration 5000
+      "$BUILD_DIR/bin/bustub-bpm-bench" --workload scan --duration 5000
+      ;;
+    *)
+      echo "unknown mode $MODE, expected test or bench" >&2
+      exit 1
+      ;;
+  esac
+done
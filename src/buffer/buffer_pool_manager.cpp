@@ -11,172 +11,1098 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager.h"
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <future>  // NOLINT
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <utility>
+#include <vector>
 // #include <mutex>
 
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_replacer.h"
 #include "common/config.h"
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
+#include "storage/page/buffer_pool_meta_page.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
 
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
+                                     LogManager *log_manager, ReplacerType replacer_type, size_t max_pool_size)
+    : BufferPoolManager(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_type, max_pool_size) {}
 
-  // Initially, every page is in the free list.
+BufferPoolManager::BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                     DiskManager *disk_manager, size_t replacer_k, LogManager *log_manager,
+                                     ReplacerType replacer_type, size_t max_pool_size)
+    : pool_size_(pool_size),
+      max_pool_size_(std::max(pool_size, max_pool_size)),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      frame_arena_(max_pool_size_, max_pool_size_ > pool_size),
+      disk_manager_(disk_manager),
+      disk_scheduler_(std::make_unique<DiskScheduler>(disk_manager)),
+      log_manager_(log_manager),
+      page_table_(max_pool_size_),
+      free_pages_(disk_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "a buffer pool needs at least one instance");
+  BUSTUB_ASSERT(instance_index < num_instances, "instance index out of range");
+  // we allocate a consecutive memory space for the buffer pool, with room to grow
+  pages_ = new Page[max_pool_size_];
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    pages_[i].data_ = frame_arena_.GetFrame(static_cast<frame_id_t>(i));
+  }
+  switch (replacer_type) {
+    case ReplacerType::LRUK:
+      replacer_ = std::make_unique<LRUKReplacer>(max_pool_size_, replacer_k);
+      break;
+    case ReplacerType::LRU:
+      replacer_ = std::make_unique<LRUReplacer>(max_pool_size_);
+      break;
+    case ReplacerType::Clock:
+      replacer_ = std::make_unique<ClockReplacer>(max_pool_size_);
+      break;
+  }
+
+  // Initially, every page is in the free list, and the frames past the pool size are retired.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
   }
+  for (size_t i = pool_size_; i < max_pool_size_; ++i) {
+    pages_[i].pin_count_ = -1;
+  }
+
+  // Go on allocating where the last FlushAllPages() on this disk left off.
+  if (disk_manager_ != nullptr) {
+    auto data = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+    auto *meta = reinterpret_cast<BufferPoolMetaPage *>(data.get());
+    if (disk_manager_->ReadMetaPage(instance_index_, data.get()) && meta->magic_ == BufferPoolMetaPage::MAGIC &&
+        meta->num_instances_ == num_instances_ && meta->next_page_id_ >= next_page_id_) {
+      next_page_id_ = meta->next_page_id_;
+      if (meta->free_list_head_page_id_ != INVALID_PAGE_ID &&
+          !free_pages_.Open(meta->free_list_head_page_id_, meta->next_page_id_)) {
+        LOG_WARN("free page list of buffer pool instance %u is damaged, its pages are not reused", instance_index_);
+      }
+    }
+  }
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::BufferPoolManager()
+    : pool_size_(0), max_pool_size_(0), pages_(nullptr), frame_arena_(0),
+      disk_manager_(nullptr),
+      log_manager_(nullptr),
+      page_table_(0),
+      free_pages_(nullptr) {}
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
-  if (free_list_.empty() && replacer_->Size() == 0) {
-    return nullptr;
+BufferPoolManager::~BufferPoolManager() {
+  BufferPoolManager::StopHotSetDumps();
+  BufferPoolManager::StopBackgroundWriter();
+  // Read-ahead callbacks touch the frames, so let them finish before anything is torn down.
+  while (prefetches_in_flight_ > 0) {
+    std::this_thread::yield();
   }
+  delete[] pages_;
+}
+
+auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * { return CreatePage(INVALID_PAGE_ID, page_id); }
+
+auto BufferPoolManager::NewPageAt(page_id_t page_id) -> Page * { return CreatePage(page_id, &page_id); }
+
+auto BufferPoolManager::AllocateExtent() -> page_id_t {
+  BUSTUB_ASSERT(num_instances_ == 1, "the extents of a sharded pool are allocated by ParallelBufferPoolManager");
+  std::scoped_lock lock(latch_);
+  if (free_pages_.Size() > 0) {
+    return INVALID_PAGE_ID;
+  }
+  return next_page_id_.fetch_add(DISK_EXTENT_PAGES);
+}
+
+auto BufferPoolManager::CreatePage(page_id_t page_id, page_id_t *new_page_id) -> Page * {
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  } else if (replacer_->Evict(&frame_id)) {
-    if (pages_[frame_id].IsDirty()) {
-      if (page_table_.count(pages_[frame_id].GetPageId()) != 0U) {
-        disk_manager_->WritePage(pages_[frame_id].page_id_, pages_[frame_id].data_);
-        pages_[frame_id].is_dirty_ = false;
-      }
+  bool raced = false;
+  while (!GetVictimFrame(&frame_id, &raced)) {
+    if (!raced) {
+      return nullptr;
     }
-    page_table_.erase(pages_[frame_id].page_id_);
+    // Some frame was only pinned by a lock-free fetch that lost its race and is about to let go of it.
+    metrics_.pin_waits_.Add();
+    lock.unlock();
+    std::this_thread::yield();
+    lock.lock();
+    raced = false;
   }
-
-  *page_id = AllocatePage();
-  page_table_[*page_id] = frame_id;
-  pages_[frame_id].page_id_ = *page_id;
-  pages_[frame_id].ResetMemory();
-  replacer_->RecordAccess(frame_id);
-  replacer_->SetEvictable(frame_id, false);
-  pages_[frame_id].pin_count_ += 1;
-
+  *new_page_id = page_id == INVALID_PAGE_ID ? AllocatePage() : page_id;
+  metrics_.new_pages_.Add();
+  LoadFrame(lock, frame_id, *new_page_id, false, AccessType::Unknown);
   return &pages_[frame_id];
 }
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
-  if (page_table_.count(page_id) > 0) {
-    frame_id_t frame_id = page_table_[page_id];
-    replacer_->RecordAccess(frame_id);
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  frame_id_t frame_id;
+  // Fast path: a resident page is looked up and pinned without the latch. Marking the frame non-evictable can race
+  // with an unpin that just made it evictable, but the pin count, not the replacer, is what stops an eviction.
+  if (page_table_.Find(page_id, &frame_id) && TryPinFrame(frame_id, page_id)) {
+    metrics_.hits_[AccessTypeIndex(access_type)].Add();
+    replacer_->RecordAccess(frame_id, access_type);
     replacer_->SetEvictable(frame_id, false);
-    pages_[frame_id].pin_count_ += 1;
     return &pages_[frame_id];
   }
-  if (free_list_.empty() && replacer_->Size() == 0) {
-    return nullptr;
+
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    if (FindFrame(lock, page_id, &frame_id)) {
+      metrics_.hits_[AccessTypeIndex(access_type)].Add();
+      replacer_->RecordAccess(frame_id, access_type);
+      replacer_->SetEvictable(frame_id, false);
+      pages_[frame_id].pin_count_ += 1;
+      return &pages_[frame_id];
+    }
+    bool raced = false;
+    if (GetVictimFrame(&frame_id, &raced)) {
+      auto start = std::chrono::steady_clock::now();
+      LoadFrame(lock, frame_id, page_id, true, access_type);
+      metrics_.misses_[AccessTypeIndex(access_type)].Add();
+      metrics_.miss_latency_[AccessTypeIndex(access_type)].RecordSince(start);
+      return &pages_[frame_id];
+    }
+    if (!raced) {
+      return nullptr;
+    }
+    metrics_.pin_waits_.Add();
+    // Let the lock-free fetch that pinned a frame under us give it back, then look for the page again.
+    lock.unlock();
+    std::this_thread::yield();
+    lock.lock();
   }
+}
+
+auto BufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  BUSTUB_ASSERT(std::adjacent_find(page_ids.begin(), page_ids.end(), std::greater_equal<>()) == page_ids.end(),
+                "page ids must be sorted and distinct");
+  std::vector<Page *> pages(page_ids.size(), nullptr);
+  std::vector<size_t> misses;
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(latch_);
+
+  // Pin the resident pages first, so that the misses below cannot evict them.
   frame_id_t frame_id;
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  } else if (replacer_->Evict(&frame_id)) {
-    if (pages_[frame_id].IsDirty()) {
-      if (page_table_.count(pages_[frame_id].GetPageId()) != 0U) {
-        disk_manager_->WritePage(pages_[frame_id].page_id_, pages_[frame_id].data_);
-        pages_[frame_id].is_dirty_ = false;
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    if (!FindFrame(lock, page_ids[i], &frame_id)) {
+      misses.push_back(i);
+      continue;
+    }
+    metrics_.hits_[AccessTypeIndex(access_type)].Add();
+    replacer_->RecordAccess(frame_id, access_type);
+    replacer_->SetEvictable(frame_id, false);
+    pages_[frame_id].pin_count_ += 1;
+    pages[i] = &pages_[frame_id];
+  }
+
+  std::vector<frame_id_t> loaded;
+  std::vector<std::pair<page_id_t, const char *>> write_backs;
+  std::vector<std::pair<page_id_t, char *>> reads;
+  for (auto i : misses) {
+    const page_id_t page_id = page_ids[i];
+    bool raced = false;
+    while (true) {
+      // The page may have been brought in while the latch was released. Waiting for another thread's I/O here could
+      // wait for one of this batch's own write-backs, so such pages are left to the caller.
+      if (page_table_.Find(page_id, &frame_id)) {
+        auto &page = pages_[frame_id];
+        if (!page.io_in_progress_ && page.page_id_ == page_id && page.pin_count_ >= 0) {
+          metrics_.hits_[AccessTypeIndex(access_type)].Add();
+          replacer_->RecordAccess(frame_id, access_type);
+          replacer_->SetEvictable(frame_id, false);
+          page.pin_count_ += 1;
+          pages[i] = &page;
+        }
+        break;
+      }
+      if (GetVictimFrame(&frame_id, &raced)) {
+        auto &page = pages_[frame_id];
+        const page_id_t old_page_id = InstallPage(frame_id, page_id, access_type);
+        if (old_page_id != INVALID_PAGE_ID) {
+          write_backs.emplace_back(old_page_id, page.data_);
+        }
+        reads.emplace_back(page_id, page.data_);
+        loaded.push_back(frame_id);
+        pages[i] = &page;
+        break;
+      }
+      if (!raced) {
+        break;
       }
+      metrics_.pin_waits_.Add();
+      lock.unlock();
+      std::this_thread::yield();
+      lock.lock();
+      raced = false;
     }
-    page_table_.erase(pages_[frame_id].page_id_);
   }
-  pages_[frame_id].ResetMemory();
-  pages_[frame_id].page_id_ = page_id;
+  if (loaded.empty()) {
+    return pages;
+  }
 
-  page_table_[page_id] = frame_id;
-  disk_manager_->ReadPage(page_id, pages_[frame_id].data_);
-  replacer_->RecordAccess(frame_id);
-  replacer_->SetEvictable(frame_id, false);
-  pages_[frame_id].pin_count_ += 1;
-  return &pages_[frame_id];
+  lock.unlock();
+  if (!write_backs.empty()) {
+    auto write_back_start = std::chrono::steady_clock::now();
+    WritePageRuns(&write_backs);
+    metrics_.dirty_write_backs_.Add(write_backs.size());
+    metrics_.write_back_latency_.RecordSince(write_back_start);
+  }
+  for (auto frame_id : loaded) {
+    pages_[frame_id].ResetMemory();
+  }
+  ReadPageRuns(&reads);
+  lock.lock();
+
+  for (const auto &[old_page_id, data] : write_backs) {
+    page_table_.Erase(old_page_id);
+  }
+  for (auto frame_id : loaded) {
+    auto &page = pages_[frame_id];
+    page.io_in_progress_ = false;
+    page.io_done_.notify_all();
+    metrics_.misses_[AccessTypeIndex(access_type)].Add();
+    metrics_.miss_latency_[AccessTypeIndex(access_type)].RecordSince(start);
+  }
+  return pages;
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
   std::scoped_lock<std::mutex> lock(latch_);
-  if (page_table_.count(page_id) == 0 || pages_[page_table_[page_id]].pin_count_ == 0) {
+  frame_id_t frame_id;
+  // A frame whose page id differs is still writing back page_id, which is no longer pinned by anyone.
+  if (!page_table_.Find(page_id, &frame_id) || pages_[frame_id].page_id_ != page_id ||
+      pages_[frame_id].pin_count_ <= 0) {
     return false;
   }
-  pages_[page_table_[page_id]].pin_count_ -= 1;
-  if (pages_[page_table_[page_id]].pin_count_ == 0) {
-    replacer_->SetEvictable(page_table_[page_id], true);
+  auto &page = pages_[frame_id];
+  page.is_dirty_ |= is_dirty;
+  if (page.pin_count_.fetch_sub(1) == 1) {
+    replacer_->SetEvictable(frame_id, true);
   }
-  pages_[page_table_[page_id]].is_dirty_ |= is_dirty;
   return true;
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
-  if (page_table_.count(page_id) == 0) {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!FindFrame(lock, page_id, &frame_id)) {
     return false;
   }
-  disk_manager_->WritePage(page_id, pages_[page_table_[page_id]].data_);
-  pages_[page_table_[page_id]].is_dirty_ = false;
+  WriteBackFrames(lock, {frame_id});
   return true;
 }
 
 void BufferPoolManager::FlushAllPages() {
-  std::scoped_lock<std::mutex> lock(latch_);
-  for (auto [pid, fid] : page_table_) {
-    if (page_table_.count(pid) != 0U) {
-      disk_manager_->WritePage(pid, pages_[fid].data_);
-      pages_[fid].is_dirty_ = false;
+  WriteBackPages(0, std::numeric_limits<page_id_t>::max());
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    CheckpointAllocationState();
+  }
+  // Page writes are not synced one by one, so this is where they become durable.
+  disk_manager_->Sync();
+}
+
+void BufferPoolManager::FlushDirtyPages(page_id_t first_page_id, page_id_t last_page_id) {
+  WriteBackPages(first_page_id, last_page_id);
+  disk_manager_->Sync();
+}
+
+void BufferPoolManager::WriteBackPages(page_id_t first_page_id, page_id_t last_page_id) {
+  std::unique_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frame_ids;
+  // Frames past the end of a shrinking pool may still hold pages.
+  for (size_t i = 0; i < max_pool_size_; i++) {
+    auto &page = pages_[i];
+    page_id_t page_id = page.page_id_;
+    // Frames with I/O in flight are being written back or filled by another thread, and claimed frames are not ours.
+    if (page_id < first_page_id || page_id >= last_page_id || page.io_in_progress_ || page.pin_count_ < 0) {
+      continue;
+    }
+    if (page.is_dirty_ || page.pin_count_ > 0) {
+      frame_ids.push_back(static_cast<frame_id_t>(i));
     }
   }
+  WriteBackFrames(lock, frame_ids);
+}
+
+void BufferPoolManager::WriteBackFrames(std::unique_lock<std::mutex> &lock, const std::vector<frame_id_t> &frame_ids) {
+  if (frame_ids.empty()) {
+    return;
+  }
+  // Unpinned frames are claimed, so nobody changes them during the write. Frames in use get one more pin and are
+  // written under their read latch, which their users take to change them.
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  std::vector<frame_id_t> claimed;
+  std::vector<frame_id_t> in_use;
+  for (auto frame_id : frame_ids) {
+    auto &page = pages_[frame_id];
+    if (ClaimForWriteBack(frame_id)) {
+      page.is_dirty_ = false;
+      pages.emplace_back(page.page_id_, page.data_);
+      claimed.push_back(frame_id);
+    } else {
+      page.pin_count_ += 1;
+      in_use.push_back(frame_id);
+    }
+  }
+
+  // The scheduler's read-ahead callbacks take the latch, so it must not be held while waiting for the writes. Page
+  // latches are only waited for while this thread holds no other latch and no claim: anyone holding a page's write
+  // latch may be about to fetch a claimed page or latch another one. Free ones go into the batch right away.
+  lock.unlock();
+  std::vector<frame_id_t> latched;
+  std::vector<frame_id_t> busy;
+  for (auto frame_id : in_use) {
+    (pages_[frame_id].TryRLatch() ? latched : busy).push_back(frame_id);
+  }
+  lock.lock();
+  for (auto frame_id : latched) {
+    auto &page = pages_[frame_id];
+    page.is_dirty_ = false;
+    pages.emplace_back(page.page_id_, page.data_);
+  }
+  lock.unlock();
+  WritePageRuns(&pages);
+  for (auto frame_id : latched) {
+    pages_[frame_id].RUnlatch();
+  }
+  lock.lock();
+  for (auto frame_id : claimed) {
+    auto &page = pages_[frame_id];
+    page.io_in_progress_ = false;
+    page.io_done_.notify_all();
+    if (page.pin_count_.fetch_sub(1) == 1) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  lock.unlock();
+
+  for (auto frame_id : busy) {
+    auto &page = pages_[frame_id];
+    page.RLatch();
+    lock.lock();
+    page.is_dirty_ = false;
+    lock.unlock();
+    std::vector<std::pair<page_id_t, const char *>> single{{page.page_id_, page.data_}};
+    WritePageRuns(&single);
+    page.RUnlatch();
+  }
+  lock.lock();
+  for (auto frame_id : in_use) {
+    if (pages_[frame_id].pin_count_.fetch_sub(1) == 1) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+}
+
+void BufferPoolManager::WritePageRuns(std::vector<std::pair<page_id_t, const char *>> *pages) {
+  std::sort(pages->begin(), pages->end());
+  // Hand every run to the disk scheduler first and wait afterwards, so that the runs are written in parallel.
+  std::vector<std::future<bool>> futures;
+  size_t run_start = 0;
+  for (size_t i = 1; i <= pages->size(); i++) {
+    bool extends_run = i < pages->size() && (*pages)[i].first == (*pages)[i - 1].first + 1 &&
+                       i - run_start < static_cast<size_t>(WRITE_BACK_MAX_RUN_PAGES);
+    if (extends_run) {
+      continue;
+    }
+    DiskRequest request{true, nullptr, (*pages)[run_start].first, disk_scheduler_->CreatePromise()};
+    for (size_t j = run_start; j < i; j++) {
+      request.pages_data_.push_back((*pages)[j].second);
+    }
+    futures.push_back(request.callback_.get_future());
+    disk_scheduler_->Schedule(std::move(request));
+    run_start = i;
+  }
+  for (auto &future : futures) {
+    future.get();
+  }
+}
+
+void BufferPoolManager::ReadPageRuns(std::vector<std::pair<page_id_t, char *>> *pages) {
+  std::sort(pages->begin(), pages->end());
+  std::vector<std::future<bool>> futures;
+  size_t run_start = 0;
+  for (size_t i = 1; i <= pages->size(); i++) {
+    bool extends_run = i < pages->size() && (*pages)[i].first == (*pages)[i - 1].first + 1 &&
+                       i - run_start < static_cast<size_t>(READ_MAX_RUN_PAGES);
+    if (extends_run) {
+      continue;
+    }
+    DiskRequest request{false, nullptr, (*pages)[run_start].first, disk_scheduler_->CreatePromise()};
+    for (size_t j = run_start; j < i; j++) {
+      request.read_pages_data_.push_back((*pages)[j].second);
+    }
+    futures.push_back(request.callback_.get_future());
+    disk_scheduler_->Schedule(std::move(request));
+    run_start = i;
+  }
+  for (auto &future : futures) {
+    future.get();
+  }
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
-  if (page_table_.count(page_id) == 0) {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!FindFrame(lock, page_id, &frame_id)) {
+    DeallocatePage(page_id);
     return true;
   }
-  frame_id_t frame_id = page_table_[page_id];
-  if (pages_[frame_id].GetPinCount() > 0) {
+  auto &page = pages_[frame_id];
+  int unpinned = 0;
+  if (!page.pin_count_.compare_exchange_strong(unpinned, -1)) {
     return false;
   }
-  if (pages_[frame_id].IsDirty()) {
-    disk_manager_->WritePage(page_id, pages_[frame_id].data_);
-    pages_[frame_id].is_dirty_ = false;
-  }
-  page_table_.erase(page_id);
+  // The page's contents are garbage from now on, so a dirty page is not written back.
+  page.is_dirty_ = false;
+  page_table_.Erase(page_id);
   replacer_->Remove(frame_id);
-  free_list_.emplace_back(frame_id);
-  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
-  pages_[frame_id].ResetMemory();
+  page.page_id_ = INVALID_PAGE_ID;
+  page.ResetMemory();
+  // A frame past the end of a shrinking pool stays claimed, which retires it.
+  if (static_cast<size_t>(frame_id) < pool_size_) {
+    free_list_.emplace_back(frame_id);
+    page.pin_count_ = 0;
+  }
   DeallocatePage(page_id);
   return true;
 }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManager::Resize(size_t new_size) -> bool {
+  if (new_size == 0 || new_size > max_pool_size_) {
+    return false;
+  }
+  std::scoped_lock<std::mutex> resize_lock(resize_latch_);
+  if (new_size < pool_size_) {
+    ShrinkTo(new_size);
+    return true;
+  }
+  // Every frame past the current size is retired, since a shrink finishes before the next Resize() starts.
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (size_t i = pool_size_; i < new_size; i++) {
+    pages_[i].pin_count_ = 0;
+    free_list_.emplace_back(static_cast<frame_id_t>(i));
+  }
+  pool_size_ = new_size;
+  return true;
+}
+
+void BufferPoolManager::ShrinkTo(size_t new_size) {
+  size_t old_size;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    old_size = pool_size_;
+    // From now on no frame past new_size is handed out. The free ones are retired right away.
+    pool_size_ = new_size;
+    free_list_.remove_if([&](frame_id_t frame_id) {
+      if (static_cast<size_t>(frame_id) < new_size) {
+        return false;
+      }
+      int unpinned = 0;
+      while (!pages_[frame_id].pin_count_.compare_exchange_weak(unpinned, -1)) {
+        unpinned = 0;
+        std::this_thread::yield();
+      }
+      return true;
+    });
+  }
+  for (size_t first = new_size; first < old_size; first += RESIZE_BATCH_FRAMES) {
+    auto last = std::min(old_size, first + RESIZE_BATCH_FRAMES);
+    while (!RetireFrames(static_cast<frame_id_t>(first), static_cast<frame_id_t>(last))) {
+      // Wait for the pinned pages to be unpinned.
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  frame_arena_.Discard(static_cast<frame_id_t>(new_size), old_size - new_size);
+}
+
+auto BufferPoolManager::RetireFrames(frame_id_t first_frame_id, frame_id_t last_frame_id) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
+  bool retired_all = true;
+  std::vector<std::pair<page_id_t, const char *>> write_backs;
+  std::vector<frame_id_t> written_frames;
+  for (frame_id_t frame_id = first_frame_id; frame_id < last_frame_id; frame_id++) {
+    auto &page = pages_[frame_id];
+    if (page.page_id_ == INVALID_PAGE_ID && page.pin_count_ < 0) {
+      continue;
+    }
+    int unpinned = 0;
+    if (!page.pin_count_.compare_exchange_strong(unpinned, -1)) {
+      retired_all = false;
+      continue;
+    }
+    replacer_->Remove(frame_id);
+    if (page.page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    if (page.is_dirty_) {
+      // Like an eviction: the mapping stays until the page is on disk, and fetches of it wait for the write.
+      page.io_in_progress_ = true;
+      write_backs.emplace_back(page.page_id_, page.data_);
+      written_frames.push_back(frame_id);
+      continue;
+    }
+    page_table_.Erase(page.page_id_);
+    page.page_id_ = INVALID_PAGE_ID;
+  }
+  if (written_frames.empty()) {
+    return retired_all;
+  }
+
+  lock.unlock();
+  WritePageRuns(&write_backs);
+  lock.lock();
+  metrics_.dirty_write_backs_.Add(written_frames.size());
+  for (auto frame_id : written_frames) {
+    auto &page = pages_[frame_id];
+    page_table_.Erase(page.page_id_);
+    page.page_id_ = INVALID_PAGE_ID;
+    page.is_dirty_ = false;
+    page.io_in_progress_ = false;
+    page.io_done_.notify_all();
+  }
+  return retired_all;
+}
+
+void BufferPoolManager::StartBackgroundWriter(size_t clean_target, size_t max_writes_per_round) {
+  BUSTUB_ASSERT(bg_writer_thread_ == nullptr, "background writer is already running");
+  bg_clean_target_ = clean_target;
+  bg_max_writes_ = max_writes_per_round;
+  enable_bg_writer_ = true;
+  bg_writer_thread_ = new std::thread(&BufferPoolManager::RunBackgroundWriter, this);
+}
+
+void BufferPoolManager::StopBackgroundWriter() {
+  enable_bg_writer_ = false;
+  if (bg_writer_thread_ != nullptr) {
+    bg_writer_thread_->join();
+    delete bg_writer_thread_;
+    bg_writer_thread_ = nullptr;
+  }
+}
+
+void BufferPoolManager::RunBackgroundWriter() {
+  while (enable_bg_writer_) {
+    std::this_thread::sleep_for(bg_writer_interval);
+    WriteBackColdPages();
+  }
+}
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, FetchPage(page_id)}; }
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
-  auto page = FetchPage(page_id);
+auto BufferPoolManager::WriteBackColdPages() -> size_t {
+  std::vector<frame_id_t> frame_ids;
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    size_t free_frames = free_list_.size();
+    if (free_frames >= bg_clean_target_) {
+      return 0;
+    }
+    std::vector<frame_id_t> victims;
+    replacer_->PeekVictims(bg_clean_target_ - free_frames, &victims);
+    for (auto frame_id : victims) {
+      if (frame_ids.size() >= bg_max_writes_) {
+        break;
+      }
+      auto &page = pages_[frame_id];
+      // Skip frames that a lock-free fetch has just pinned, and frames that are being loaded.
+      if (!page.is_dirty_ || page.io_in_progress_ || !ClaimForWriteBack(frame_id)) {
+        continue;
+      }
+      page.is_dirty_ = false;
+      frame_ids.push_back(frame_id);
+      pages.emplace_back(page.page_id_, page.data_);
+    }
+  }
+  if (frame_ids.empty()) {
+    return 0;
+  }
+
+  // Nobody can pin the claimed frames, so their data stays as it is until the write is done and no latch is needed.
+  WritePageRuns(&pages);
+  metrics_.background_writes_.Add(frame_ids.size());
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  // The pages were cold and are clean now: put them back where they were, the coldest last so it is evicted first.
+  for (auto it = frame_ids.rbegin(); it != frame_ids.rend(); ++it) {
+    auto &page = pages_[*it];
+    page.io_in_progress_ = false;
+    page.io_done_.notify_all();
+    if (page.pin_count_.fetch_sub(1) == 1) {
+      replacer_->ReturnVictim(*it);
+    }
+  }
+  return frame_ids.size();
+}
+
+auto BufferPoolManager::DumpHotSet(const std::string &path) -> bool {
+  std::vector<HotPage> pages;
+  CollectHotPages(&pages);
+  return HotSetFile::Write(path, pages);
+}
+
+auto BufferPoolManager::LoadHotSet(const std::string &path) -> size_t {
+  std::vector<HotPage> pages;
+  if (!HotSetFile::Read(path, &pages)) {
+    return 0;
+  }
+  return LoadHotPages(pages);
+}
+
+void BufferPoolManager::StartHotSetDumps(const std::string &path) {
+  BUSTUB_ASSERT(hot_set_dumper_thread_ == nullptr, "hot set dumps are already running");
+  enable_hot_set_dumps_ = true;
+  hot_set_dumper_thread_ = new std::thread(&BufferPoolManager::RunHotSetDumps, this, path);
+}
+
+void BufferPoolManager::StopHotSetDumps() {
+  {
+    std::scoped_lock<std::mutex> lock(hot_set_dumper_latch_);
+    enable_hot_set_dumps_ = false;
+  }
+  hot_set_dumper_cv_.notify_all();
+  if (hot_set_dumper_thread_ != nullptr) {
+    hot_set_dumper_thread_->join();
+    delete hot_set_dumper_thread_;
+    hot_set_dumper_thread_ = nullptr;
+  }
+}
+
+void BufferPoolManager::RunHotSetDumps(const std::string &path) {
+  std::unique_lock<std::mutex> lock(hot_set_dumper_latch_);
+  while (!hot_set_dumper_cv_.wait_for(lock, hot_set_dump_interval, [this] { return !enable_hot_set_dumps_; })) {
+    lock.unlock();
+    DumpHotSet(path);
+    lock.lock();
+  }
+}
+
+void BufferPoolManager::CollectHotPages(std::vector<HotPage> *pages) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> victims;
+  replacer_->PeekVictims(max_pool_size_, &victims);
+  std::vector<bool> evictable(max_pool_size_, false);
+  for (auto frame_id : victims) {
+    evictable[frame_id] = true;
+  }
+  auto collect = [this, pages](frame_id_t frame_id) {
+    auto &page = pages_[frame_id];
+    // Skip frames that are being loaded, evicted or retired; their page may not be the one they will hold.
+    if (page.page_id_ == INVALID_PAGE_ID || page.io_in_progress_ || page.pin_count_ < 0) {
+      return;
+    }
+    const AccessHistory history = replacer_->GetHistory(frame_id);
+    pages->push_back({page.page_id_, static_cast<uint32_t>(history.accesses_), history.scan_});
+  };
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    if (!evictable[i]) {
+      collect(static_cast<frame_id_t>(i));
+    }
+  }
+  for (auto it = victims.rbegin(); it != victims.rend(); ++it) {
+    collect(*it);
+  }
+}
+
+auto BufferPoolManager::LoadHotPages(const std::vector<HotPage> &pages) -> size_t {
+  std::unique_lock<std::mutex> lock(latch_);
+  // Pick the hottest pages of this shard that are not resident, one per free frame.
+  std::vector<const HotPage *> chosen;
+  std::unordered_set<page_id_t> seen;
+  for (const auto &hot : pages) {
+    if (chosen.size() >= free_list_.size()) {
+      break;
+    }
+    frame_id_t frame_id;
+    if (hot.page_id_ < 0 ||
+        hot.page_id_ % static_cast<page_id_t>(num_instances_) != static_cast<page_id_t>(instance_index_) ||
+        page_table_.Find(hot.page_id_, &frame_id) || !seen.insert(hot.page_id_).second) {
+      continue;
+    }
+    chosen.push_back(&hot);
+  }
+  if (chosen.empty()) {
+    return 0;
+  }
+
+  // Install them coldest first and replay their history, so the replacer sees the hottest pages as the most recent.
+  std::vector<std::pair<page_id_t, frame_id_t>> frames;
+  for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+    const HotPage &hot = **it;
+    const AccessType access_type = hot.scan_ ? AccessType::Scan : AccessType::Unknown;
+    frame_id_t frame_id;
+    bool raced = false;
+    if (!GetVictimFrame(&frame_id, &raced)) {
+      break;
+    }
+    InstallPage(frame_id, hot.page_id_, access_type);
+    for (uint32_t i = 1; i < hot.accesses_; ++i) {
+      replacer_->RecordAccess(frame_id, access_type);
+    }
+    frames.emplace_back(hot.page_id_, frame_id);
+    // The page exists on disk, so it must not be allocated again.
+    if (next_page_id_ <= hot.page_id_) {
+      next_page_id_ = hot.page_id_ + static_cast<page_id_t>(num_instances_);
+    }
+  }
+
+  // Read them all at once, one vectored read per run of pages that are adjacent in the file.
+  std::vector<std::pair<page_id_t, char *>> reads;
+  for (const auto &[page_id, frame_id] : frames) {
+    reads.emplace_back(page_id, pages_[frame_id].data_);
+  }
+  lock.unlock();
+  ReadPageRuns(&reads);
+  lock.lock();
+  // Unpin them coldest first, too.
+  for (const auto &[page_id, frame_id] : frames) {
+    auto &page = pages_[frame_id];
+    page.io_in_progress_ = false;
+    page.io_done_.notify_all();
+    if (page.pin_count_.fetch_sub(1) == 1) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  metrics_.prefetches_.Add(frames.size());
+  return frames.size();
+}
+
+void BufferPoolManager::PrefetchPages(page_id_t page_id, size_t count, const NextPageIdFunc &next_page_id) {
+  PrefetchChain(page_id, count, next_page_id, this);
+}
+
+void BufferPoolManager::PrefetchChain(page_id_t page_id, size_t count, const NextPageIdFunc &next_page_id,
+                                      BufferPoolManager *pool) {
+  count = std::min(count, pool->GetPoolSize() / 8);
+  if (page_id == INVALID_PAGE_ID || count == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) {
+    auto &page = pages_[frame_id];
+    // Another thread is loading the page (often an earlier read-ahead, which continues the chain itself) or writing
+    // back the frame's old page.
+    if (page.io_in_progress_) {
+      return;
+    }
+    // The page is resident: only follow its link. Don't wait for a writer, and don't count this as an access.
+    replacer_->SetEvictable(frame_id, false);
+    page.pin_count_ += 1;
+    lock.unlock();
+    page_id_t next = INVALID_PAGE_ID;
+    if (page.TryRLatch()) {
+      next = next_page_id(page.GetData());
+      page.RUnlatch();
+    }
+    lock.lock();
+    if (page.pin_count_.fetch_sub(1) == 1) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+    lock.unlock();
+    pool->PrefetchPages(next, count - 1, next_page_id);
+    return;
+  }
+
+  bool raced = false;
+  if (!GetVictimFrame(&frame_id, &raced)) {
+    return;
+  }
+  auto &page = pages_[frame_id];
+  const page_id_t old_page_id = InstallPage(frame_id, page_id, AccessType::Unknown);
+  lock.unlock();
+  // With the background writer running, the victim is usually clean already.
+  if (old_page_id != INVALID_PAGE_ID) {
+    auto start = std::chrono::steady_clock::now();
+    disk_manager_->WritePage(old_page_id, page.data_);
+    metrics_.dirty_write_backs_.Add();
+    metrics_.write_back_latency_.RecordSince(start);
+  }
+  page.ResetMemory();
+  metrics_.prefetches_.Add();
+
+  // The read completes on a scheduler thread, which installs the page and then starts the next read of the chain.
+  pool->prefetches_in_flight_ += 1;
+  DiskRequest request{false, page.data_, page_id, disk_scheduler_->CreatePromise()};
+  request.on_complete_ = [this, frame_id, old_page_id, count, next_page_id, pool] {
+    auto &page = pages_[frame_id];
+    // Nobody else touches the page's data until io_in_progress_ is cleared.
+    const page_id_t next = count > 1 ? next_page_id(page.GetData()) : INVALID_PAGE_ID;
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      if (old_page_id != INVALID_PAGE_ID) {
+        page_table_.Erase(old_page_id);
+      }
+      page.io_in_progress_ = false;
+      page.io_done_.notify_all();
+      if (page.pin_count_.fetch_sub(1) == 1) {
+        replacer_->SetEvictable(frame_id, true);
+      }
+    }
+    pool->PrefetchPages(next, count - 1, next_page_id);
+    pool->prefetches_in_flight_ -= 1;
+  };
+  disk_scheduler_->Schedule(std::move(request));
+}
+
+auto BufferPoolManager::FindFrame(std::unique_lock<std::mutex> &lock, page_id_t page_id, frame_id_t *frame_id)
+    -> bool {
+  while (true) {
+    if (!page_table_.Find(page_id, frame_id)) {
+      return false;
+    }
+    auto &page = pages_[*frame_id];
+    if (!page.io_in_progress_) {
+      return true;
+    }
+    metrics_.pin_waits_.Add();
+    // The mapping may change while we sleep (e.g. a write-back finishes and drops it), so look it up again.
+    page.io_done_.wait(lock);
+  }
+}
+
+auto BufferPoolManager::TryPinFrame(frame_id_t frame_id, page_id_t page_id) -> bool {
+  auto &page = pages_[frame_id];
+  if (page.page_id_ != page_id) {
+    return false;
+  }
+  int pin_count = page.pin_count_;
+  do {
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page.pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  // The frame cannot be claimed while we hold a pin, so if it still holds page_id with no I/O in flight it is ours.
+  if (page.page_id_ == page_id && !page.io_in_progress_) {
+    return true;
+  }
+  // The frame changed hands between the lookup and the pin. A free frame is in no replacer and whoever wants it
+  // spins until we let go, so it is given back right away; otherwise the pin may be the last one and must be
+  // dropped under the latch, like in UnpinPage().
+  if (page.page_id_ == INVALID_PAGE_ID) {
+    page.pin_count_ -= 1;
+    return false;
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (page.pin_count_.fetch_sub(1) == 1) {
+    replacer_->SetEvictable(frame_id, true);
+  }
+  return false;
+}
+
+auto BufferPoolManager::ClaimForWriteBack(frame_id_t frame_id) -> bool {
+  auto &page = pages_[frame_id];
+  // The flag goes up before the pin: a lock-free fetch pins first and checks the flag after, so either our pin fails
+  // or the fetch sees the flag and backs off.
+  page.io_in_progress_ = true;
+  int unpinned = 0;
+  if (page.pin_count_.compare_exchange_strong(unpinned, 1)) {
+    replacer_->SetEvictable(frame_id, false);
+    return true;
+  }
+  page.io_in_progress_ = false;
+  page.io_done_.notify_all();
+  return false;
+}
+
+auto BufferPoolManager::GetVictimFrame(frame_id_t *frame_id, bool *raced) -> bool {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    int unpinned = 0;
+    while (!pages_[*frame_id].pin_count_.compare_exchange_weak(unpinned, -1)) {
+      unpinned = 0;
+      std::this_thread::yield();
+    }
+    return true;
+  }
+  while (replacer_->Evict(frame_id)) {
+    // The frame is past the end of a shrinking pool; Resize() retires it.
+    if (static_cast<size_t>(*frame_id) >= pool_size_) {
+      continue;
+    }
+    int unpinned = 0;
+    if (pages_[*frame_id].pin_count_.compare_exchange_strong(unpinned, -1)) {
+      metrics_.evictions_.Add();
+      return true;
+    }
+    // A lock-free fetch pinned the frame after it became evictable. Keep tracking it; its last unpin makes it
+    // evictable again.
+    replacer_->RecordAccess(*frame_id);
+    replacer_->SetEvictable(*frame_id, false);
+    *raced = true;
+  }
+  return false;
+}
+
+auto BufferPoolManager::InstallPage(frame_id_t frame_id, page_id_t page_id, AccessType access_type) -> page_id_t {
+  auto &page = pages_[frame_id];
+  const page_id_t old_page_id = page.page_id_;
+  const bool write_back = old_page_id != INVALID_PAGE_ID && page.is_dirty_;
+  if (old_page_id != INVALID_PAGE_ID && !write_back) {
+    page_table_.Erase(old_page_id);
+  }
+
+  // Publish the new mapping right away so concurrent fetches of page_id wait on this frame instead of loading the
+  // page a second time. A dirty old page keeps its entry until it is on disk, so a fetch of it cannot read stale
+  // data in the meantime. The frame is marked io_in_progress_ before it is unclaimed (pin count -1 -> 1), so a
+  // lock-free fetch that pins it from then on backs off until the frame is ready.
+  page.io_in_progress_ = true;
+  page_table_.Insert(page_id, frame_id);
+  page.page_id_ = page_id;
+  page.is_dirty_ = false;
+  page.pin_count_ = 1;
+  replacer_->RecordAccess(frame_id, access_type);
+  replacer_->SetEvictable(frame_id, false);
+  return write_back ? old_page_id : INVALID_PAGE_ID;
+}
+
+void BufferPoolManager::LoadFrame(std::unique_lock<std::mutex> &lock, frame_id_t frame_id, page_id_t page_id,
+                                  bool read, AccessType access_type) {
+  auto &page = pages_[frame_id];
+  const page_id_t old_page_id = InstallPage(frame_id, page_id, access_type);
+  const bool write_back = old_page_id != INVALID_PAGE_ID;
+
+  if (!write_back && !read) {
+    page.ResetMemory();
+    page.io_in_progress_ = false;
+    return;
+  }
+
+  lock.unlock();
+  if (write_back) {
+    auto start = std::chrono::steady_clock::now();
+    disk_manager_->WritePage(old_page_id, page.data_);
+    metrics_.dirty_write_backs_.Add();
+    metrics_.write_back_latency_.RecordSince(start);
+  }
+  page.ResetMemory();
+  if (read) {
+    disk_manager_->ReadPage(page_id, page.data_);
+  }
+  lock.lock();
+
+  if (write_back) {
+    page_table_.Erase(old_page_id);
+  }
+  page.io_in_progress_ = false;
+  page.io_done_.notify_all();
+}
+
+auto BufferPoolManager::AllocatePage() -> page_id_t {
+  page_id_t page_id;
+  const bool reused = free_pages_.Pop(&page_id);
+  ReadFreeListHead();
+  if (reused) {
+    return page_id;
+  }
+  page_id = next_page_id_.fetch_add(static_cast<page_id_t>(num_instances_));
+  BUSTUB_ASSERT(page_id % static_cast<page_id_t>(num_instances_) == static_cast<page_id_t>(instance_index_),
+                "allocated page id does not belong to this instance");
+  return page_id;
+}
+
+void BufferPoolManager::ReadFreeListHead() {
+  const page_id_t trunk_page_id = free_pages_.StartHeadRead();
+  if (trunk_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  // Until the read is done, AllocatePage() hands out fresh pages.
+  auto data = std::make_shared<std::vector<char>>(BUSTUB_PAGE_SIZE);
+  prefetches_in_flight_ += 1;
+  DiskRequest request{false, data->data(), trunk_page_id, disk_scheduler_->CreatePromise()};
+  request.on_complete_ = [this, trunk_page_id, data] {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      free_pages_.LoadHead(trunk_page_id, data->data());
+    }
+    prefetches_in_flight_ -= 1;
+  };
+  disk_scheduler_->Schedule(std::move(request));
+}
+
+void BufferPoolManager::CheckpointAllocationState() {
+  free_pages_.Flush();
+  auto data = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  auto *meta = reinterpret_cast<BufferPoolMetaPage *>(data.get());
+  meta->magic_ = BufferPoolMetaPage::MAGIC;
+  meta->num_instances_ = num_instances_;
+  meta->next_page_id_ = next_page_id_;
+  meta->free_list_head_page_id_ = free_pages_.GetHeadPageId();
+  disk_manager_->WriteMetaPage(instance_index_, data.get());
+}
+
+void BufferPoolManager::DeallocatePage(page_id_t page_id) {
+  // Ignore ids this shard never handed out; putting them on the free list would hand them out twice.
+  if (page_id < 0 || page_id >= next_page_id_ ||
+      page_id % static_cast<page_id_t>(num_instances_) != static_cast<page_id_t>(instance_index_)) {
+    return;
+  }
+  free_pages_.Push(page_id);
+}
+
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type) -> BasicPageGuard {
+  return {this, FetchPage(page_id, access_type)};
+}
+
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type) -> ReadPageGuard {
+  auto page = FetchPage(page_id, access_type);
   if (page != nullptr) {
     page->RLatch();
   }
   return {this, page};
 }
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
-  auto page = FetchPage(page_id);
+auto BufferPoolManager::FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<ReadPageGuard> {
+  std::vector<page_id_t> distinct_ids = page_ids;
+  std::sort(distinct_ids.begin(), distinct_ids.end());
+  distinct_ids.erase(std::unique(distinct_ids.begin(), distinct_ids.end()), distinct_ids.end());
+  auto pages = FetchPages(distinct_ids, access_type);
+  std::vector<ReadPageGuard> guards;
+  guards.reserve(pages.size());
+  for (auto *page : pages) {
+    if (page != nullptr) {
+      page->RLatch();
+      guards.emplace_back(this, page);
+    }
+  }
+  return guards;
+}
+
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type) -> WritePageGuard {
+  auto page = FetchPage(page_id, access_type);
   if (page != nullptr) {
     page->WLatch();
   }
   return {this, page};
 }
 
+auto BufferPoolManager::FetchPageOptimistic(page_id_t page_id, AccessType access_type) -> OptimisticPageGuard {
+  auto page = FetchPage(page_id, access_type);
+  if (page == nullptr) {
+    return {};
+  }
+  return {this, page, page->StableVersion()};
+}
+
 auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, NewPage(page_id)}; }
 
 }  // namespace bustub
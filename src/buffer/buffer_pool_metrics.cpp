@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.cpp
+//
+// Identification: src/buffer/buffer_pool_metrics.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_metrics.h"
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+static constexpr std::array<const char *, NUM_ACCESS_TYPES> ACCESS_TYPE_NAMES = {"unknown", "get", "scan"};
+
+void BufferPoolMetricsSnapshot::Merge(const BufferPoolMetricsSnapshot &other) {
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; i++) {
+    hits_[i] += other.hits_[i];
+    misses_[i] += other.misses_[i];
+    miss_latency_[i].Merge(other.miss_latency_[i]);
+  }
+  new_pages_ += other.new_pages_;
+  evictions_ += other.evictions_;
+  dirty_write_backs_ += other.dirty_write_backs_;
+  write_back_latency_.Merge(other.write_back_latency_);
+  background_writes_ += other.background_writes_;
+  prefetches_ += other.prefetches_;
+  pin_waits_ += other.pin_waits_;
+}
+
+auto BufferPoolMetricsSnapshot::HitRatio() const -> double {
+  uint64_t hits = 0;
+  uint64_t fetches = 0;
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; i++) {
+    hits += hits_[i];
+    fetches += hits_[i] + misses_[i];
+  }
+  return fetches == 0 ? 0 : static_cast<double>(hits) / static_cast<double>(fetches);
+}
+
+auto BufferPoolMetricsSnapshot::ToRows() const -> std::vector<std::pair<std::string, std::string>> {
+  std::vector<std::pair<std::string, std::string>> rows;
+  rows.emplace_back("hit_ratio", fmt::format("{:.4f}", HitRatio()));
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; i++) {
+    rows.emplace_back(fmt::format("hits.{}", ACCESS_TYPE_NAMES[i]), std::to_string(hits_[i]));
+    rows.emplace_back(fmt::format("misses.{}", ACCESS_TYPE_NAMES[i]), std::to_string(misses_[i]));
+    rows.emplace_back(fmt::format("miss_latency.{}", ACCESS_TYPE_NAMES[i]), miss_latency_[i].ToString());
+  }
+  rows.emplace_back("new_pages", std::to_string(new_pages_));
+  rows.emplace_back("evictions", std::to_string(evictions_));
+  rows.emplace_back("dirty_write_backs", std::to_string(dirty_write_backs_));
+  rows.emplace_back("write_back_latency", write_back_latency_.ToString());
+  rows.emplace_back("background_writes", std::to_string(background_writes_));
+  rows.emplace_back("prefetches", std::to_string(prefetches_));
+  rows.emplace_back("pin_waits", std::to_string(pin_waits_));
+  return rows;
+}
+
+auto BufferPoolMetrics::Snapshot() const -> BufferPoolMetricsSnapshot {
+  BufferPoolMetricsSnapshot snapshot;
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; i++) {
+    snapshot.hits_[i] = hits_[i].Get();
+    snapshot.misses_[i] = misses_[i].Get();
+    snapshot.miss_latency_[i] = miss_latency_[i].Snapshot();
+  }
+  snapshot.new_pages_ = new_pages_.Get();
+  snapshot.evictions_ = evictions_.Get();
+  snapshot.dirty_write_backs_ = dirty_write_backs_.Get();
+  snapshot.write_back_latency_ = write_back_latency_.Snapshot();
+  snapshot.background_writes_ = background_writes_.Get();
+  snapshot.prefetches_ = prefetches_.Get();
+  snapshot.pin_waits_ = pin_waits_.Get();
+  return snapshot;
+}
+
+}  // namespace bustub
@@ -12,18 +12,100 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : slots_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // The first lap clears every reference bit it passes, so the second lap is guaranteed to find a victim.
+  while (true) {
+    auto &slot = slots_[hand_];
+    auto current = static_cast<frame_id_t>(hand_);
+    hand_ = (hand_ + 1) % slots_.size();
+    if (!slot.tracked_ || !slot.evictable_) {
+      continue;
+    }
+    if (slot.referenced_) {
+      slot.referenced_ = false;
+      continue;
+    }
+    slot = ClockSlot{};
+    curr_size_ -= 1;
+    *frame_id = current;
+    return true;
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < slots_.size(), "frame id invalid");
+  auto &slot = slots_[frame_id];
+  if (!slot.tracked_) {
+    slot.tracked_ = true;
+    slot.evictable_ = true;
+    curr_size_ += 1;
+  }
+  if (access_type != AccessType::Scan) {
+    slot.referenced_ = true;
+  }
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < slots_.size(), "frame id invalid");
+  auto &slot = slots_[frame_id];
+  if (!slot.tracked_ || slot.evictable_ == set_evictable) {
+    return;
+  }
+  slot.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_ += 1;
+  } else {
+    curr_size_ -= 1;
+  }
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < slots_.size(), "frame id invalid");
+  auto &slot = slots_[frame_id];
+  if (slot.tracked_ && slot.evictable_) {
+    curr_size_ -= 1;
+  }
+  slot = ClockSlot{};
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // Frames without a reference bit go in the first lap, in the order the hand reaches them; the others follow in
+  // the second lap.
+  for (bool referenced : {false, true}) {
+    for (size_t i = 0; i < slots_.size() && frame_ids->size() < max_frames; i++) {
+      size_t index = (hand_ + i) % slots_.size();
+      const auto &slot = slots_[index];
+      if (slot.tracked_ && slot.evictable_ && slot.referenced_ == referenced) {
+        frame_ids->push_back(static_cast<frame_id_t>(index));
+      }
+    }
+  }
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  RecordAccess(frame_id);
+  SetEvictable(frame_id, true);
+}
 
 }  // namespace bustub
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator.cpp
+//
+// Identification: src/buffer/extent_allocator.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/extent_allocator.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+auto ExtentAllocator::NewPage(page_id_t *page_id) -> Page * {
+  page_id_t new_page_id;
+  uint64_t extent = extent_.load();
+  while (true) {
+    new_page_id = NextOf(extent);
+    if (new_page_id < EndOf(extent)) {
+      if (extent_.compare_exchange_weak(extent, Pack(new_page_id + 1, EndOf(extent)))) {
+        break;
+      }
+      continue;
+    }
+    // The extent is used up. Whoever gets the latch first reserves the next one; the others retry on it.
+    std::scoped_lock lock(latch_);
+    extent = extent_.load();
+    if (NextOf(extent) < EndOf(extent)) {
+      continue;
+    }
+    new_page_id = bpm_->AllocateExtent();
+    if (new_page_id == INVALID_PAGE_ID) {
+      return bpm_->NewPage(page_id);
+    }
+    extent_ = Pack(new_page_id + 1, new_page_id + DISK_EXTENT_PAGES);
+    break;
+  }
+  auto *page = bpm_->NewPageAt(new_page_id);
+  if (page == nullptr) {
+    // Every frame is pinned. Free the id again, so that a retry does not leave a hole in the extent.
+    bpm_->DeletePage(new_page_id);
+    return nullptr;
+  }
+  *page_id = new_page_id;
+  return page;
+}
+
+auto ExtentAllocator::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {bpm_, NewPage(page_id)}; }
+
+}  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <cstdint>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+FrameArena::FrameArena(size_t num_frames, bool discardable) : size_(num_frames * BUSTUB_PAGE_SIZE) {
+  if (size_ == 0) {
+    return;
+  }
+  void *data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (USE_HUGE_PAGES && !discardable && size_ >= HUGE_PAGE_SIZE) {
+    size_t huge_size = (size_ + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    // Fails unless the administrator has reserved huge pages (vm.nr_hugepages).
+    data = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      size_ = huge_size;
+      huge_pages_ = true;
+    }
+  }
+#endif
+  if (data == MAP_FAILED) {
+    // mmap only aligns to the OS page size; map a page of slack and trim it so frames are aligned to their size.
+    size_t slack = BUSTUB_PAGE_SIZE;
+    data = mmap(nullptr, size_ + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the buffer pool frames");
+    }
+    auto start = reinterpret_cast<uintptr_t>(data);
+    auto aligned = (start + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE * BUSTUB_PAGE_SIZE;
+    if (aligned > start) {
+      munmap(data, aligned - start);
+    }
+    if (start + slack > aligned) {
+      munmap(reinterpret_cast<char *>(aligned + size_), start + slack - aligned);
+    }
+    data = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (USE_HUGE_PAGES && size_ >= HUGE_PAGE_SIZE) {
+      // Only a hint; transparent huge pages may be disabled.
+      madvise(data, size_, MADV_HUGEPAGE);
+    }
+#endif
+  }
+  data_ = static_cast<char *>(data);
+}
+
+void FrameArena::Discard(frame_id_t first_frame_id, size_t num_frames) {
+  if (num_frames == 0 || huge_pages_) {
+    return;
+  }
+  // Only a hint: if it fails, the memory simply stays committed.
+  madvise(GetFrame(first_frame_id), num_frames * BUSTUB_PAGE_SIZE, MADV_DONTNEED);
+}
+
+FrameArena::~FrameArena() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+}  // namespace bustub
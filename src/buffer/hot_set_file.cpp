@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hot_set_file.cpp
+//
+// Identification: src/buffer/hot_set_file.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/hot_set_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+namespace bustub {
+
+auto HotSetFile::Write(const std::string &path, const std::vector<HotPage> &pages) -> bool {
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return false;
+    }
+    uint32_t header[2] = {MAGIC, static_cast<uint32_t>(pages.size())};
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    for (const auto &page : pages) {
+      Record record{page.page_id_, page.accesses_, page.scan_ ? 1U : 0U};
+      out.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    }
+    out.flush();
+    if (!out.good()) {
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+auto HotSetFile::Read(const std::string &path, std::vector<HotPage> *pages) -> bool {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    return false;
+  }
+  uint32_t header[2];
+  if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != MAGIC) {
+    return false;
+  }
+  std::vector<HotPage> result;
+  // A damaged count must not make us allocate gigabytes; a short file fails below anyway.
+  result.reserve(std::min<uint32_t>(header[1], 1U << 20));
+  Record record;
+  for (uint32_t i = 0; i < header[1]; i++) {
+    if (!in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+      return false;
+    }
+    result.push_back({record.page_id_, record.accesses_, record.scan_ != 0});
+  }
+  *pages = std::move(result);
+  return true;
+}
+
+}  // namespace bustub
@@ -16,135 +16,185 @@
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : nodes_(num_frames), replacer_size_(num_frames), k_(k) {}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
   std::scoped_lock<std::mutex> lock(latch_);
-  for (auto it = history_.rbegin(); it != history_.rend(); ++it) {
-    auto evictable_it = evictable_.find(*it);
-    if (evictable_it != evictable_.end() && evictable_it->second) {
-      *frame_id = *it;
-      records_.erase(*frame_id);
-
-      auto history_hash_it = history_hash_.find(*frame_id);
-      if (history_hash_it != history_hash_.end()) {
-        history_.erase(history_hash_it->second);
-        history_hash_.erase(history_hash_it);
-      }
-
-      curr_size_ -= 1;
-      evictable_.erase(evictable_it);
-      return true;
-    }
+  // Frames with fewer than k accesses have +inf backward k-distance and go first, oldest first access first.
+  LRUKList &list = history_.tail_ != -1 ? history_ : cache_;
+  if (list.tail_ == -1) {
+    return false;
   }
+  *frame_id = list.tail_;
+  Unlink(list, *frame_id);
+  nodes_[*frame_id] = LRUKNode{};
+  curr_size_ -= 1;
+  return true;
+}
 
-  for (auto it = cache_.rbegin(); it != cache_.rend(); ++it) {
-    auto evictable_it = evictable_.find(*it);
-    if (evictable_it != evictable_.end() && evictable_it->second) {
-      *frame_id = *it;
-      records_.erase(*frame_id);
-
-      auto cache_hash_it = cache_hash_.find(*frame_id);
-      if (cache_hash_it != cache_hash_.end()) {
-        cache_.erase(cache_hash_it->second);
-        cache_hash_.erase(cache_hash_it);
-      }
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id invalid");
 
-      curr_size_ -= 1;
-      evictable_.erase(evictable_it);
-      return true;
+  auto &node = nodes_[frame_id];
+  if (node.accesses_ == 0) {
+    node.accesses_ = 1;
+    node.evictable_ = true;
+    node.scan_ = access_type == AccessType::Scan;
+    curr_size_ += 1;
+    Link(frame_id);
+    return;
+  }
+  if (access_type == AccessType::Scan) {
+    // A scan neither makes a frame hotter nor cools down a frame that was used otherwise.
+    return;
+  }
+  if (node.scan_) {
+    // The first access that is not a scan counts as the first access of the frame.
+    if (node.evictable_) {
+      Unlink(ListOf(node), frame_id);
     }
+    node.scan_ = false;
+    node.accesses_ = 1;
+    if (node.evictable_) {
+      PushFront(ListOf(node), frame_id);
+    }
+    return;
+  }
+  if (node.accesses_ + 1 < k_) {
+    // The history list is ordered by first access, so the frame stays where it is.
+    node.accesses_ += 1;
+    return;
+  }
+  if (node.evictable_) {
+    Unlink(ListOf(node), frame_id);
+  }
+  node.accesses_ = k_;
+  if (node.evictable_) {
+    PushFront(cache_, frame_id);
   }
-
-  return false;
 }
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   std::scoped_lock<std::mutex> lock(latch_);
   BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id invalid");
 
-  auto record_it = records_.find(frame_id);
-  if (record_it == records_.end()) {
-    evictable_[frame_id] = true;
-    records_[frame_id] = 1;
+  auto &node = nodes_[frame_id];
+  if (node.accesses_ == 0 || node.evictable_ == set_evictable) {
+    return;
+  }
+  node.evictable_ = set_evictable;
+  if (set_evictable) {
+    Link(frame_id);
     curr_size_ += 1;
-    history_.push_front(frame_id);
-    history_hash_[frame_id] = history_.begin();
-  } else if (record_it->second + 1 < k_) {
-    record_it->second += 1;
-  } else if (record_it->second + 1 == k_) {
-    record_it->second += 1;
-    auto it = history_hash_.find(frame_id);
-    if (it != history_hash_.end()) {
-      history_.erase(it->second);
-      history_hash_.erase(it);
-    }
-    cache_.push_front(frame_id);
-    cache_hash_[frame_id] = cache_.begin();
   } else {
-    auto it = cache_hash_.find(frame_id);
-    if (it != cache_hash_.end()) {
-      cache_.erase(it->second);
-      cache_hash_.erase(it);
-    }
-    cache_.push_front(frame_id);
-    cache_hash_[frame_id] = cache_.begin();
+    Unlink(ListOf(node), frame_id);
+    curr_size_ -= 1;
   }
 }
 
-void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+void LRUKReplacer::ReturnVictim(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
   BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id invalid");
 
-  auto records_it = records_.find(frame_id);
-  if (records_it == records_.end() || records_it->second == 0) {
+  auto &node = nodes_[frame_id];
+  if (node.accesses_ == 0 || node.evictable_) {
     return;
   }
+  node.evictable_ = true;
+  PushBack(ListOf(node), frame_id);
+  curr_size_ += 1;
+}
 
-  auto evictable_it = evictable_.find(frame_id);
-  if (evictable_it != evictable_.end()) {
-    if (evictable_it->second && !set_evictable) {
-      curr_size_ -= 1;
-    } else if (!evictable_it->second && set_evictable) {
-      curr_size_ += 1;
-    }
-    evictable_it->second = set_evictable;
-  } else {
-    evictable_[frame_id] = set_evictable;
-    if (set_evictable) {
-      curr_size_ += 1;
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id invalid");
+
+  auto &node = nodes_[frame_id];
+  if (node.accesses_ == 0) {
+    return;
+  }
+  if (node.evictable_) {
+    Unlink(ListOf(node), frame_id);
+    curr_size_ -= 1;
+  }
+  node = LRUKNode{};
+}
+
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+void LRUKReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (LRUKList *list : {&history_, &cache_}) {
+    for (frame_id_t frame_id = list->tail_; frame_id != -1 && frame_ids->size() < max_frames;
+         frame_id = nodes_[frame_id].prev_) {
+      frame_ids->push_back(frame_id);
     }
   }
 }
 
-void LRUKReplacer::Remove(frame_id_t frame_id) {
+auto LRUKReplacer::GetHistory(frame_id_t frame_id) -> AccessHistory {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id invalid");
+  return {nodes_[frame_id].accesses_, nodes_[frame_id].scan_};
+}
+
+auto LRUKReplacer::IsTracked(frame_id_t frame_id) -> bool {
   std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id invalid");
+  return nodes_[frame_id].accesses_ != 0;
+}
 
-  auto cache_hash_it = cache_hash_.find(frame_id);
-  if (cache_hash_it != cache_hash_.end()) {
-    cache_.erase(cache_hash_it->second);
-    cache_hash_.erase(cache_hash_it);
+void LRUKReplacer::PushFront(LRUKList &list, frame_id_t frame_id) {
+  auto &node = nodes_[frame_id];
+  node.prev_ = -1;
+  node.next_ = list.head_;
+  if (list.head_ != -1) {
+    nodes_[list.head_].prev_ = frame_id;
+  } else {
+    list.tail_ = frame_id;
   }
+  list.head_ = frame_id;
+}
 
-  auto history_hash_it = history_hash_.find(frame_id);
-  if (history_hash_it != history_hash_.end()) {
-    history_.erase(history_hash_it->second);
-    history_hash_.erase(history_hash_it);
+void LRUKReplacer::PushBack(LRUKList &list, frame_id_t frame_id) {
+  auto &node = nodes_[frame_id];
+  node.prev_ = list.tail_;
+  node.next_ = -1;
+  if (list.tail_ != -1) {
+    nodes_[list.tail_].next_ = frame_id;
+  } else {
+    list.head_ = frame_id;
   }
+  list.tail_ = frame_id;
+}
 
-  auto evictable_it = evictable_.find(frame_id);
-  if (evictable_it != evictable_.end()) {
-    if (evictable_it->second) {
-      curr_size_ -= 1;
-    }
-    evictable_.erase(evictable_it);
+void LRUKReplacer::Link(frame_id_t frame_id) {
+  auto &node = nodes_[frame_id];
+  if (node.scan_) {
+    PushBack(ListOf(node), frame_id);
+  } else {
+    PushFront(ListOf(node), frame_id);
   }
-  records_.erase(frame_id);
 }
 
-auto LRUKReplacer::Size() -> size_t {
-  std::scoped_lock<std::mutex> lock(latch_);
-  return curr_size_;
+void LRUKReplacer::Unlink(LRUKList &list, frame_id_t frame_id) {
+  auto &node = nodes_[frame_id];
+  if (node.prev_ != -1) {
+    nodes_[node.prev_].next_ = node.next_;
+  } else {
+    list.head_ = node.next_;
+  }
+  if (node.next_ != -1) {
+    nodes_[node.next_].prev_ = node.prev_;
+  } else {
+    list.tail_ = node.prev_;
+  }
+  node.prev_ = -1;
+  node.next_ = -1;
 }
 
 }  // namespace bustub
@@ -14,16 +14,15 @@
 
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) : LRUKReplacer(num_pages, 1) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-auto LRUReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
-
-void LRUReplacer::Pin(frame_id_t frame_id) {}
-
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
-
-auto LRUReplacer::Size() -> size_t { return 0; }
+void LRUReplacer::Unpin(frame_id_t frame_id) {
+  if (!IsTracked(frame_id)) {
+    RecordAccess(frame_id);
+  }
+  SetEvictable(frame_id, true);
+}
 
 }  // namespace bustub
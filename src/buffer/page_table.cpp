@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) {
+  // A frame can be mapped twice while its old page is written back, so keep the load factor at or below one half
+  // even then.
+  capacity_ = 16;
+  while (capacity_ < num_frames * 4) {
+    capacity_ <<= 1;
+  }
+  mask_ = capacity_ - 1;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+auto PageTable::Home(page_id_t page_id) const -> size_t {
+  // Page ids are mostly dense, so scramble them (Fibonacci hashing) before masking.
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >> 32) &
+         mask_;
+}
+
+auto PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+  size_t slot = Home(page_id);
+  for (size_t probes = 0; probes < capacity_; probes++) {
+    uint64_t entry = slots_[slot].load(std::memory_order_acquire);
+    if (entry == EMPTY_SLOT) {
+      return false;
+    }
+    if (PageOf(entry) == page_id) {
+      *frame_id = FrameOf(entry);
+      return true;
+    }
+    slot = (slot + 1) & mask_;
+  }
+  return false;
+}
+
+auto PageTable::SlotOf(page_id_t page_id) const -> size_t {
+  size_t slot = Home(page_id);
+  for (size_t probes = 0; probes < capacity_; probes++) {
+    uint64_t entry = slots_[slot].load(std::memory_order_relaxed);
+    if (entry == EMPTY_SLOT) {
+      return capacity_;
+    }
+    if (PageOf(entry) == page_id) {
+      return slot;
+    }
+    slot = (slot + 1) & mask_;
+  }
+  return capacity_;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot map an invalid page id");
+  BUSTUB_ASSERT(size_ < capacity_ / 2, "page table is full");
+  size_t slot = Home(page_id);
+  while (slots_[slot].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+    BUSTUB_ASSERT(PageOf(slots_[slot].load(std::memory_order_relaxed)) != page_id, "page is already mapped");
+    slot = (slot + 1) & mask_;
+  }
+  slots_[slot].store(Pack(page_id, frame_id), std::memory_order_release);
+  size_++;
+}
+
+auto PageTable::Erase(page_id_t page_id) -> bool {
+  size_t hole = SlotOf(page_id);
+  if (hole == capacity_) {
+    return false;
+  }
+  // Backward-shift deletion: pull later entries of the probe run into the hole so that no tombstones are needed.
+  // Each entry is copied into the hole before its old slot is cleared, so a concurrent Find() sees it at least once
+  // unless it has already probed past the hole.
+  size_t slot = (hole + 1) & mask_;
+  while (true) {
+    uint64_t entry = slots_[slot].load(std::memory_order_relaxed);
+    if (entry == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = Home(PageOf(entry));
+    // The entry may move into the hole only if the hole lies on its probe path, i.e. cyclically in [home, slot).
+    if (((slot - home) & mask_) >= ((slot - hole) & mask_)) {
+      slots_[hole].store(entry, std::memory_order_release);
+      hole = slot;
+    }
+    slot = (slot + 1) & mask_;
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  size_--;
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,244 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     ReplacerType replacer_type, size_t max_pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "a buffer pool needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManager>(pool_size, static_cast<uint32_t>(num_instances),
+                                                                static_cast<uint32_t>(i), disk_manager, replacer_k,
+                                                                log_manager, replacer_type, max_pool_size));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // The dumper calls DumpHotSet() of this object, which reads the shards.
+  StopHotSetDumps();
+  // Read-ahead chains hop between shards, so they must all be done before the first shard goes away.
+  while (prefetches_in_flight_ > 0) {
+    std::this_thread::yield();
+  }
+}
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+auto ParallelBufferPoolManager::GetMaxPoolSize() -> size_t {
+  size_t max_pool_size = 0;
+  for (auto &instance : instances_) {
+    max_pool_size += instance->GetMaxPoolSize();
+  }
+  return max_pool_size;
+}
+
+auto ParallelBufferPoolManager::Resize(size_t new_size) -> bool {
+  size_t num_instances = instances_.size();
+  auto share = [&](size_t i) { return new_size / num_instances + (i < new_size % num_instances ? 1 : 0); };
+  for (size_t i = 0; i < num_instances; i++) {
+    if (share(i) == 0 || share(i) > instances_[i]->GetMaxPoolSize()) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_[i]->Resize(share(i));
+  }
+  return true;
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager * {
+  BUSTUB_ASSERT(page_id >= 0, "invalid page id");
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
+  size_t start = next_instance_.fetch_add(1) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); i++) {
+    auto *page = instances_[(start + i) % instances_.size()]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::AllocateExtent() -> page_id_t {
+  std::vector<std::unique_lock<std::mutex>> locks;
+  page_id_t first_page_id = 0;
+  for (auto &instance : instances_) {
+    locks.emplace_back(instance->latch_);
+    first_page_id = std::max(first_page_id, instance->next_page_id_.load());
+  }
+  for (auto &instance : instances_) {
+    if (instance->free_pages_.Size() > 0) {
+      return INVALID_PAGE_ID;
+    }
+  }
+  const page_id_t end = first_page_id + DISK_EXTENT_PAGES;
+  const auto num_instances = static_cast<page_id_t>(instances_.size());
+  for (page_id_t i = 0; i < num_instances; i++) {
+    auto &instance = instances_[i];
+    for (page_id_t skipped = instance->next_page_id_; skipped < first_page_id; skipped += num_instances) {
+      instance->free_pages_.Push(skipped);
+    }
+    // The first id past the extent that belongs to shard i.
+    instance->next_page_id_ = end + (i - end % num_instances + num_instances) % num_instances;
+  }
+  return first_page_id;
+}
+
+auto ParallelBufferPoolManager::NewPageAt(page_id_t page_id) -> Page * {
+  return GetBufferPoolManager(page_id)->NewPageAt(page_id);
+}
+
+auto ParallelBufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, access_type);
+}
+
+auto ParallelBufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  // Each part stays sorted, since it is a subsequence of page_ids.
+  std::vector<std::vector<page_id_t>> shard_ids(instances_.size());
+  std::vector<std::vector<size_t>> positions(instances_.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    BUSTUB_ASSERT(page_ids[i] >= 0, "invalid page id");
+    size_t shard = static_cast<size_t>(page_ids[i]) % instances_.size();
+    shard_ids[shard].push_back(page_ids[i]);
+    positions[shard].push_back(i);
+  }
+  std::vector<Page *> pages(page_ids.size(), nullptr);
+  for (size_t shard = 0; shard < instances_.size(); ++shard) {
+    if (shard_ids[shard].empty()) {
+      continue;
+    }
+    auto shard_pages = instances_[shard]->FetchPages(shard_ids[shard], access_type);
+    for (size_t j = 0; j < shard_pages.size(); ++j) {
+      pages[positions[shard][j]] = shard_pages[j];
+    }
+  }
+  return pages;
+}
+
+auto ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty, access_type);
+}
+
+auto ParallelBufferPoolManager::FlushPage(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPages() {
+  for (auto &instance : instances_) {
+    instance->WriteBackPages(0, std::numeric_limits<page_id_t>::max());
+    std::scoped_lock<std::mutex> lock(instance->latch_);
+    instance->CheckpointAllocationState();
+  }
+  instances_.front()->disk_manager_->Sync();
+}
+
+void ParallelBufferPoolManager::FlushDirtyPages(page_id_t first_page_id, page_id_t last_page_id) {
+  for (auto &instance : instances_) {
+    instance->WriteBackPages(first_page_id, last_page_id);
+  }
+  instances_.front()->disk_manager_->Sync();
+}
+
+auto ParallelBufferPoolManager::DeletePage(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::StartBackgroundWriter(size_t clean_target, size_t max_writes_per_round) {
+  size_t num_instances = instances_.size();
+  for (auto &instance : instances_) {
+    instance->StartBackgroundWriter((clean_target + num_instances - 1) / num_instances,
+                                    (max_writes_per_round + num_instances - 1) / num_instances);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto &instance : instances_) {
+    instance->StopBackgroundWriter();
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchPages(page_id_t page_id, size_t count, const NextPageIdFunc &next_page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  GetBufferPoolManager(page_id)->PrefetchChain(page_id, count, next_page_id, this);
+}
+
+auto ParallelBufferPoolManager::DumpHotSet(const std::string &path) -> bool {
+  std::vector<std::vector<HotPage>> shard_pages(instances_.size());
+  size_t total = 0;
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    instances_[i]->CollectHotPages(&shard_pages[i]);
+    total += shard_pages[i].size();
+  }
+  std::vector<HotPage> pages;
+  pages.reserve(total);
+  for (size_t rank = 0; pages.size() < total; ++rank) {
+    for (auto &shard : shard_pages) {
+      if (rank < shard.size()) {
+        pages.push_back(shard[rank]);
+      }
+    }
+  }
+  return HotSetFile::Write(path, pages);
+}
+
+auto ParallelBufferPoolManager::LoadHotSet(const std::string &path) -> size_t {
+  std::vector<HotPage> pages;
+  if (!HotSetFile::Read(path, &pages)) {
+    return 0;
+  }
+  std::vector<std::vector<HotPage>> shard_pages(instances_.size());
+  for (const auto &hot : pages) {
+    if (hot.page_id_ >= 0) {
+      shard_pages[hot.page_id_ % instances_.size()].push_back(hot);
+    }
+  }
+  size_t loaded = 0;
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    loaded += instances_[i]->LoadHotPages(shard_pages[i]);
+  }
+  return loaded;
+}
+
+auto ParallelBufferPoolManager::GetMetrics() -> BufferPoolMetricsSnapshot {
+  BufferPoolMetricsSnapshot metrics;
+  for (auto &instance : instances_) {
+    metrics.Merge(instance->GetMetrics());
+  }
+  return metrics;
+}
+
+}  // namespace bustub
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.cpp
+//
+// Identification: src/buffer/read_ahead.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+
+namespace bustub {
+
+auto ReadAheadWindow::Advance() -> size_t {
+  if (ahead_ > 0) {
+    ahead_--;
+  }
+  // Ask for more while half of the window is still ahead, so the next reads are in flight before the scan needs them.
+  if (ahead_ > window_ / 2) {
+    return 0;
+  }
+  window_ = window_ == 0 ? READ_AHEAD_MIN_PAGES : std::min<size_t>(window_ * 2, READ_AHEAD_MAX_PAGES);
+  ahead_ = window_;
+  return window_;
+}
+
+}  // namespace bustub
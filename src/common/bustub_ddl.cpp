@@ -127,6 +127,29 @@ void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainState
 
 void BustubInstance::HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt,
                                                  ResultWriter &writer) {
+  // Built-in read-only variables with the statistics of the storage layer.
+  std::vector<std::pair<std::string, std::string>> metrics;
+  if (stmt.variable_ == "buffer_pool_metrics" && buffer_pool_manager_ != nullptr) {
+    metrics = buffer_pool_manager_->GetMetrics().ToRows();
+  } else if (stmt.variable_ == "disk_metrics") {
+    metrics = disk_manager_->GetMetrics().ToRows();
+  }
+  if (!metrics.empty()) {
+    writer.BeginTable(false);
+    writer.BeginHeader();
+    writer.WriteHeaderCell("metric");
+    writer.WriteHeaderCell("value");
+    writer.EndHeader();
+    for (const auto &[name, value] : metrics) {
+      writer.BeginRow();
+      writer.WriteCell(name);
+      writer.WriteCell(value);
+      writer.EndRow();
+    }
+    writer.EndTable();
+    return;
+  }
+
   auto content = GetSessionVariable(stmt.variable_);
   WriteOneCell(fmt::format("{}={}", stmt.variable_, content), writer);
 }
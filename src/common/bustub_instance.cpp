@@ -60,6 +60,13 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
     buffer_pool_manager_ = nullptr;
   }
 
+  // Warm the buffer pool up with the pages that were hot at the last shutdown before accepting any query.
+  if (buffer_pool_manager_ != nullptr) {
+    hot_set_file_name_ = db_file_name + ".hot";
+    buffer_pool_manager_->LoadHotSet(hot_set_file_name_);
+    buffer_pool_manager_->StartHotSetDumps(hot_set_file_name_);
+  }
+
   // Transaction (txn) related.
 
   lock_manager_ = new LockManager();
@@ -176,6 +183,7 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+SHOW buffer_pool_metrics / SHOW disk_metrics: show buffer pool and disk I/O statistics
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -358,6 +366,10 @@ BustubInstance::~BustubInstance() {
   delete catalog_;
   delete checkpoint_manager_;
   delete log_manager_;
+  if (buffer_pool_manager_ != nullptr && !hot_set_file_name_.empty()) {
+    buffer_pool_manager_->StopHotSetDumps();
+    buffer_pool_manager_->DumpHotSet(hot_set_file_name_);
+  }
   delete buffer_pool_manager_;
   delete lock_manager_;
   delete txn_manager_;
@@ -20,4 +20,8 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds bg_writer_interval = std::chrono::milliseconds(10);
+
+std::chrono::milliseconds hot_set_dump_interval = std::chrono::milliseconds(60000);
+
 }  // namespace bustub
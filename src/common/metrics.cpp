@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics.cpp
+//
+// Identification: src/common/metrics.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/metrics.h"
+
+#include <algorithm>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto ShardedCounter::ShardIndex() -> size_t {
+  static std::atomic<size_t> next_shard{0};
+  thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+  return shard;
+}
+
+auto ShardedCounter::Get() const -> uint64_t {
+  uint64_t sum = 0;
+  for (const auto &shard : shards_) {
+    sum += shard.value_.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+void HistogramSnapshot::Merge(const HistogramSnapshot &other) {
+  for (size_t i = 0; i < counts_.size(); i++) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ns_ += other.sum_ns_;
+}
+
+auto HistogramSnapshot::PercentileNs(double percentile) const -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count_));
+  rank = std::clamp<uint64_t>(rank, 1, count_);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return uint64_t{2} << i;
+    }
+  }
+  return uint64_t{2} << (counts_.size() - 1);
+}
+
+auto HistogramSnapshot::ToString() const -> std::string {
+  uint64_t max_ns = 0;
+  for (size_t i = counts_.size(); i > 0; i--) {
+    if (counts_[i - 1] > 0) {
+      max_ns = uint64_t{2} << (i - 1);
+      break;
+    }
+  }
+  return fmt::format("count={} mean={}us p50<={}us p99<={}us max<={}us", count_, MeanNs() / 1000,
+                     PercentileNs(50) / 1000, PercentileNs(99) / 1000, max_ns / 1000);
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds duration) {
+  auto ns = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+  size_t bucket = 0;
+  for (uint64_t v = ns >> 1; v != 0 && bucket + 1 < counts_.size(); v >>= 1) {
+    bucket++;
+  }
+  counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::Snapshot() const -> HistogramSnapshot {
+  HistogramSnapshot snapshot;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    snapshot.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+    snapshot.count_ += snapshot.counts_[i];
+  }
+  snapshot.sum_ns_ = sum_ns_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+}  // namespace bustub
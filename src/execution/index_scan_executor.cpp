@@ -21,17 +21,27 @@ IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanP
 void IndexScanExecutor::Init() {}
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  while (!it_.IsEnd()) {
-    auto id = (*it_).second;
-    auto [m, t] = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)->table_->GetTuple(id);
-    ++it_;
+  while (true) {
+    if (batch_pos_ == batch_.size()) {
+      // Resolve the next RIDs together, so that the table pages they miss on are read in parallel.
+      std::vector<RID> rids;
+      while (!it_.IsEnd() && rids.size() < static_cast<size_t>(FETCH_BATCH_MAX_RIDS)) {
+        rids.push_back((*it_).second);
+        ++it_;
+      }
+      if (rids.empty()) {
+        return false;
+      }
+      batch_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)->table_->GetTuples(rids);
+      batch_pos_ = 0;
+    }
+    auto &[m, t] = batch_[batch_pos_++];
     if (!m.is_deleted_) {
-      *tuple = t;
-      *rid = id;
+      *rid = t.GetRid();
+      *tuple = std::move(t);
       return true;
     }
   }
-  return false;
 }
 
 }  // namespace bustub
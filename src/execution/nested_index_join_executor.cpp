@@ -29,30 +29,58 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
   }
 }
 
-void NestIndexJoinExecutor::Init() { child_executor_->Init(); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  left_tuples_.clear();
+  right_tuples_.clear();
+  batch_pos_ = 0;
+}
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+auto NestIndexJoinExecutor::NextBatch() -> bool {
+  left_tuples_.clear();
+  right_tuples_.clear();
+  batch_pos_ = 0;
+  auto outer_schema = child_executor_->GetOutputSchema();
+  std::vector<RID> rids;
+  std::vector<size_t> matched;
   Tuple left_tuple;
   RID id;
-  auto outer_schema = child_executor_->GetOutputSchema();
-  auto inner_schema = plan_->InnerTableSchema();
-  std::vector<Value> val;
-  while (child_executor_->Next(&left_tuple, &id)) {
+  while (left_tuples_.size() < static_cast<size_t>(FETCH_BATCH_MAX_RIDS) && child_executor_->Next(&left_tuple, &id)) {
     Value value = plan_->KeyPredicate()->Evaluate(&left_tuple, outer_schema);
     std::vector<RID> righe_result;
     it_->ScanKey(Tuple{{value}, index_info_->index_->GetKeySchema()}, &righe_result, exec_ctx_->GetTransaction());
-
-    Tuple right_tuple;
     if (!righe_result.empty()) {
-      auto [m, t] = table_info_->table_->GetTuple(*righe_result.begin());
-      right_tuple = t;
+      rids.push_back(*righe_result.begin());
+      matched.push_back(left_tuples_.size());
+    }
+    left_tuples_.push_back(left_tuple);
+  }
+  right_tuples_.resize(left_tuples_.size());
+  // Fetch the inner tuples of the whole batch at once, so that their pages are read in parallel.
+  auto inner_tuples = table_info_->table_->GetTuples(rids);
+  for (size_t i = 0; i < matched.size(); ++i) {
+    right_tuples_[matched[i]] = std::move(inner_tuples[i].second);
+  }
+  return !left_tuples_.empty();
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  auto outer_schema = child_executor_->GetOutputSchema();
+  auto inner_schema = plan_->InnerTableSchema();
+  std::vector<Value> val;
+  while (batch_pos_ < left_tuples_.size() || NextBatch()) {
+    const Tuple &left_tuple = left_tuples_[batch_pos_];
+    const std::optional<Tuple> &right_tuple = right_tuples_[batch_pos_];
+    batch_pos_++;
+
+    if (right_tuple.has_value()) {
       val.reserve((outer_schema.GetColumnCount() + inner_schema.GetColumnCount()));
 
       for (uint32_t i = 0; i < outer_schema.GetColumnCount(); ++i) {
         val.emplace_back(left_tuple.GetValue(&outer_schema, i));
       }
       for (uint32_t i = 0; i < inner_schema.GetColumnCount(); ++i) {
-        val.emplace_back(right_tuple.GetValue(&inner_schema, i));
+        val.emplace_back(right_tuple->GetValue(&inner_schema, i));
       }
       *tuple = Tuple(val, &GetOutputSchema());
       return true;
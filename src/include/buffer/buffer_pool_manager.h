@@ -12,15 +12,26 @@
 
 #pragma once
 
+#include <functional>
+#include <condition_variable>  // NOLINT
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/buffer_pool_metrics.h"
+#include "buffer/frame_arena.h"
+#include "buffer/hot_set_file.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/page_table.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/disk/free_page_list.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
 
@@ -30,24 +41,65 @@ namespace bustub {
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
 class BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
  public:
+  /** Extracts the id of the page that follows a page in a chain (e.g. a table heap or the B+ tree leaves). */
+  using NextPageIdFunc = std::function<page_id_t(const char *)>;
+
   /**
    * @brief Creates a new BufferPoolManager.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy
+   * @param max_pool_size the largest size Resize() may grow the pool to, 0 for pool_size. Frames beyond the current
+   * size cost address space, but no memory
    */
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                    LogManager *log_manager = nullptr);
+                    LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRUK,
+                    size_t max_pool_size = 0);
+
+  /**
+   * @brief Creates a new BufferPoolManager that serves as one shard of a ParallelBufferPoolManager.
+   * @param pool_size the size of this shard
+   * @param num_instances the total number of shards
+   * @param instance_index the index of this shard; every page id it allocates is congruent to it modulo num_instances
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy
+   * @param max_pool_size the largest size Resize() may grow this shard to, 0 for pool_size
+   */
+  BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index, DiskManager *disk_manager,
+                    size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                    ReplacerType replacer_type = ReplacerType::LRUK, size_t max_pool_size = 0);
 
   /**
    * @brief Destroy an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** @brief Return the size (number of frames) of the buffer pool. */
-  auto GetPoolSize() -> size_t { return pool_size_; }
+  virtual auto GetPoolSize() -> size_t { return pool_size_; }
+
+  /** @brief Return the largest size the buffer pool can be resized to. */
+  virtual auto GetMaxPoolSize() -> size_t { return max_pool_size_; }
+
+  /**
+   * @brief Grow or shrink the buffer pool while it is in use.
+   *
+   * Growing adds the new frames to the free list. Shrinking stops handing out the frames past new_size at once, then
+   * retires them RESIZE_BATCH_FRAMES at a time: clean ones are dropped, dirty ones are written back first, and the
+   * latch is released between batches, so other threads are held up for one batch at most. Pages that are pinned in
+   * those frames are waited for, so the caller must not hold any pins itself. The memory of the retired frames is
+   * given back to the OS.
+   *
+   * @param new_size the new number of frames, between 1 and GetMaxPoolSize()
+   * @return false if new_size is out of range, true once the pool has new_size frames
+   */
+  virtual auto Resize(size_t new_size) -> bool;
 
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
@@ -69,7 +121,7 @@ class BufferPoolManager {
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  auto NewPage(page_id_t *page_id) -> Page *;
+  virtual auto NewPage(page_id_t *page_id) -> Page *;
 
   /**
    * TODO(P1): Add implementation
@@ -85,6 +137,22 @@ class BufferPoolManager {
    */
   auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
 
+  /**
+   * @brief Reserve DISK_EXTENT_PAGES consecutive page ids for one table or index, which creates the pages one by one
+   * with NewPageAt() (see ExtentAllocator). Consecutive page ids are adjacent on disk, so the pages of an object that
+   * allocates from its own extents are clustered, and scans of it read them in long runs.
+   * @return the first page id of the extent, or INVALID_PAGE_ID if there are deallocated pages to reuse first, in
+   * which case the caller takes its next page from NewPage()
+   */
+  virtual auto AllocateExtent() -> page_id_t;
+
+  /**
+   * @brief Create a new page with a page id reserved by AllocateExtent(); otherwise the same as NewPage().
+   * @param page_id id of the page to create, which must not have been created before
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPageAt(page_id_t page_id) -> Page *;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -99,10 +167,10 @@ class BufferPoolManager {
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPage().
    *
    * @param page_id id of page to be fetched
-   * @param access_type type of access to the page, only needed for leaderboard tests.
+   * @param access_type type of access to the page. The replacer evicts pages that have only been scanned first.
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
-  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
+  virtual auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
 
   /**
    * TODO(P1): Add implementation
@@ -115,11 +183,50 @@ class BufferPoolManager {
    * the returned page already has a read or write latch held, respectively.
    *
    * @param page_id, the id of the page to fetch
+   * @param access_type type of access to the page, passed on to FetchPage()
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> BasicPageGuard;
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> ReadPageGuard;
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> WritePageGuard;
+
+  /**
+   * @brief Fetch a page pinned but not latched, for readers that validate what they read, see OptimisticPageGuard.
+   *
+   * If a writer holds the page latch, waits for it to finish first.
+   *
+   * @param page_id id of the page to fetch
+   * @param access_type type of access to the page, passed on to FetchPage()
+   * @return OptimisticPageGuard holding the fetched page
+   */
+  auto FetchPageOptimistic(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> OptimisticPageGuard;
+
+  /**
+   * @brief Fetch several pages at once and pin each of them, like FetchPage() does. The latch is taken once for the
+   * whole batch, and all misses are read together: adjacent pages in one vectored read, the runs in parallel on the
+   * disk scheduler, so their latencies overlap instead of adding up.
+   *
+   * Resident pages are pinned before any miss claims a frame, so the batch never evicts one of its own pages.
+   *
+   * @param page_ids ids of the pages to fetch, sorted and distinct
+   * @param access_type type of access to the pages, see FetchPage()
+   * @return the page for each id, in the same order; nullptr where no frame was free, or where the page was being
+   * loaded or written back by another thread (call FetchPage() for those)
+   */
+  virtual auto FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<Page *>;
+
+  /**
+   * @brief FetchPages() with guards: fetch the distinct ids among page_ids and read-latch each page, in ascending
+   * page id order.
+   *
+   * @param page_ids ids of the pages to fetch, in any order and possibly repeated
+   * @param access_type type of access to the pages, passed on to FetchPages()
+   * @return one guard per distinct page id, sorted by page id. Pages that FetchPages() could not fetch are left out;
+   * fetch those with FetchPageRead().
+   */
+  auto FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<ReadPageGuard>;
 
   /**
    * TODO(P1): Add implementation
@@ -135,7 +242,7 @@ class BufferPoolManager {
    * @param access_type type of access to the page, only needed for leaderboard tests.
    * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
    */
-  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
+  virtual auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
 
   /**
    * TODO(P1): Add implementation
@@ -148,20 +255,35 @@ class BufferPoolManager {
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  auto FlushPage(page_id_t page_id) -> bool;
+  virtual auto FlushPage(page_id_t page_id) -> bool;
 
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Flush all the pages in the buffer pool to disk.
+   * @brief Flush all the dirty pages in the buffer pool to disk, and sync the database file. Pinned pages are written
+   * too, since their changes are only reported when they are unpinned. See FlushDirtyPages().
+   *
+   * The free page list and the next fresh page id are saved as well, and a buffer pool later created on the same
+   * disk manager goes on from them.
+   */
+  virtual void FlushAllPages();
+
+  /**
+   * @brief Flush the dirty (or pinned) pages with ids in [first_page_id, last_page_id) to disk and sync the database
+   * file once at the end, e.g. for a checkpoint of one table. The pages are written in page id order, and runs of up
+   * to WRITE_BACK_MAX_RUN_PAGES adjacent pages go out as one vectored write.
+   *
+   * @param first_page_id the first page id of the range
+   * @param last_page_id the page id past the end of the range
    */
-  void FlushAllPages();
+  virtual void FlushDirtyPages(page_id_t first_page_id, page_id_t last_page_id);
 
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
-   * page is pinned and cannot be deleted, return false immediately.
+   * @brief Delete a page from the buffer pool and deallocate it. If page_id is not in the buffer pool, only deallocate
+   * it and return true. If the page is pinned and cannot be deleted, return false immediately. A page must not be
+   * deleted twice, since it may have been handed out again in between.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
    * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
@@ -170,43 +292,306 @@ class BufferPoolManager {
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  auto DeletePage(page_id_t page_id) -> bool;
+  virtual auto DeletePage(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Start a background thread that writes back cold dirty pages before they are evicted, so that eviction
+   * rarely has to wait for a write. Every bg_writer_interval it looks at the frames the replacer would evict next
+   * and writes back the dirty, unpinned ones among them.
+   *
+   * @param clean_target the watermark: number of free or clean evictable frames to keep at the cold end of the pool
+   * @param max_writes_per_round the rate: maximum number of pages written back per round
+   */
+  virtual void StartBackgroundWriter(size_t clean_target, size_t max_writes_per_round);
+
+  /** @brief Stop the background writer and wait for it to exit. Does nothing if it is not running. */
+  virtual void StopBackgroundWriter();
+
+  /**
+   * @brief Start loading page_id and up to count - 1 of the pages that follow it into the buffer pool, without waiting
+   * for them. Pages that are not resident are read by the disk scheduler; the chain is followed with next_page_id
+   * as each page arrives. Read-ahead is only a hint: it stops at the end of the chain, at a page another thread is
+   * loading or writing, or when no frame is free. It never reads more than an eighth of the pool ahead.
+   *
+   * A prefetched page is recorded as a single ordinary access. Recording it as a scan would make it the next victim,
+   * so the rest of the chain would evict it before the scan gets to it. The replacer still evicts it before any page
+   * that was accessed more often.
+   *
+   * @param page_id id of the first page to load, INVALID_PAGE_ID for none
+   * @param count the number of pages to load
+   * @param next_page_id extracts a page's successor in the chain from its data
+   */
+  virtual void PrefetchPages(page_id_t page_id, size_t count, const NextPageIdFunc &next_page_id);
+
+  /**
+   * @brief Write the hot set of the buffer pool to a file: the ids of its resident pages, hottest first, together with
+   * their access history in the replacer. Pinned pages count as the hottest, the evictable ones follow in the reverse
+   * of the order in which the replacer would evict them.
+   *
+   * @param path the file to write; it is replaced atomically
+   * @return false if the file could not be written
+   */
+  virtual auto DumpHotSet(const std::string &path) -> bool;
+
+  /**
+   * @brief Warm the buffer pool with a hot set written by DumpHotSet(), typically before a restarted database accepts
+   * traffic. As many of the hottest pages as there are free frames are read in page-id order, with adjacent pages
+   * coalesced into one vectored read, and their access history is replayed into the replacer so that they are
+   * evicted in the order they would have been before the restart. Pages that are already resident are skipped, and
+   * no page is ever evicted to make room, so it is safe to call while the pool is in use.
+   *
+   * @param path the file to read
+   * @return the number of pages loaded, 0 if the file is missing or corrupt
+   */
+  virtual auto LoadHotSet(const std::string &path) -> size_t;
+
+  /**
+   * @brief Start a background thread that calls DumpHotSet(path) every hot_set_dump_interval, so that a crash
+   * loses at most one interval of history.
+   * @param path the file to write
+   */
+  void StartHotSetDumps(const std::string &path);
+
+  /** @brief Stop the hot set dumps and wait for the thread to exit. Does nothing if they are not running. */
+  void StopHotSetDumps();
+
+  /** @return a snapshot of the counters and latency histograms of this buffer pool */
+  virtual auto GetMetrics() -> BufferPoolMetricsSnapshot { return metrics_.Snapshot(); }
+
+ protected:
+  /** FOR SUBCLASSES ONLY, used by ParallelBufferPoolManager, which owns no frames of its own. */
+  BufferPoolManager();
 
  private:
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
+  /** Frames retired per latch hold when the pool shrinks, see Resize(). */
+  static constexpr size_t RESIZE_BATCH_FRAMES = 64;
+
+  /**
+   * Number of pages in the buffer pool. Frames [pool_size_, max_pool_size_) are retired: they are not in the free
+   * list, hold no page and have pin count -1. While the pool shrinks, some of them may still hold pages.
+   */
+  std::atomic<size_t> pool_size_;
+  /** Number of frames that pages_ and frame_arena_ have room for. */
+  const size_t max_pool_size_;
+  /** Number of shards in the parallel buffer pool this instance belongs to, 1 if it stands alone. */
+  const uint32_t num_instances_ = 1;
+  /** Index of this shard in the parallel buffer pool. */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
 
-  /** Array of buffer pool pages. */
+  /** Array of buffer pool pages. It only holds their book-keeping; the data lives in frame_arena_. */
   Page *pages_;
+  /** The data of all frames, one page-aligned allocation. */
+  FrameArena frame_arena_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_;
+  /**
+   * Runs batches of writes (FlushAllPages(), the background writer) on a pool of I/O threads, so that many of them are
+   * in flight at once. A single read or write that a thread has to wait for anyway is done on that thread directly,
+   * which saves two context switches per miss.
+   */
+  std::unique_ptr<DiskScheduler> disk_scheduler_;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Page table for keeping track of buffer pool pages. Written under latch_, read without it by FetchPage(). */
+  PageTable page_table_;
   /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
+  std::unique_ptr<Replacer> replacer_;
+  /** True while the background writer should keep running. */
+  std::atomic<bool> enable_bg_writer_{false};
+  /** The background writer thread, nullptr if it is not running. */
+  std::thread *bg_writer_thread_{nullptr};
+  /** Watermark and rate of the background writer, see StartBackgroundWriter(). */
+  size_t bg_clean_target_{0};
+  size_t bg_max_writes_{0};
+  /** The thread that dumps the hot set periodically, nullptr if it is not running. */
+  std::thread *hot_set_dumper_thread_{nullptr};
+  /** Protects enable_hot_set_dumps_; hot_set_dumper_cv_ wakes the dumper up early when the dumps are stopped. */
+  std::mutex hot_set_dumper_latch_;
+  std::condition_variable hot_set_dumper_cv_;
+  bool enable_hot_set_dumps_{false};
+  /** Hit, miss, eviction and I/O statistics. */
+  BufferPoolMetrics metrics_;
+  /** Number of reads that read-ahead chains started through this buffer pool have in flight. */
+  std::atomic<size_t> prefetches_in_flight_{0};
+  /** Pages of this shard that were deallocated and can be reused. Protected by latch_. */
+  FreePageList free_pages_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * This latch protects page_table_, free_list_ and the book-keeping fields of every frame. It is released while a
+   * frame is being read from or written back to disk; such frames are marked io_in_progress_ and other threads that
+   * need them wait on the frame's io_done_ condition instead.
+   *
+   * FetchPage() of a resident page does not take it: it looks the page up in page_table_ and pins the frame with a
+   * compare-and-swap on its pin count (see TryPinFrame()). To keep such pins from racing with eviction, every path
+   * that repurposes a frame first claims it by swapping its pin count from 0 to -1.
+   */
   std::mutex latch_;
+  /** Serializes Resize() calls. */
+  std::mutex resize_latch_;
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk, reusing a deallocated page if there is one. Caller should acquire the latch before
+   * calling this function.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief If the free page list has moved on to a trunk page that is only on disk, read it through the disk
+   * scheduler, so that the latch is not held across the read. Caller should acquire the latch.
+   */
+  void ReadFreeListHead();
+
+  /**
+   * @brief Write the free page list and a metadata page recording it and next_page_id_, from which the constructor
+   * picks them up again. Caller should acquire the latch.
+   */
+  void CheckpointAllocationState();
+
+  /**
+   * @brief Create a new page, with a fresh page id from AllocatePage() if page_id is INVALID_PAGE_ID.
+   * @param page_id the id of the page to create, or INVALID_PAGE_ID
+   * @param[out] new_page_id id of the created page
+   */
+  auto CreatePage(page_id_t page_id, page_id_t *new_page_id) -> Page *;
+
+  /**
+   * @brief Deallocate a page on disk, so that AllocatePage() can hand it out again. Caller should acquire the latch
+   * before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
+
+  /**
+   * @brief Look up the frame holding page_id, waiting for any in-flight I/O on that frame to finish first.
+   * Caller must hold the latch through `lock`; it may be released and re-acquired while waiting.
+   * @param lock the caller's lock on latch_
+   * @param page_id id of the page to look up
+   * @param[out] frame_id the frame holding page_id
+   * @return false if page_id is not resident in the buffer pool
+   */
+  auto FindFrame(std::unique_lock<std::mutex> &lock, page_id_t page_id, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Pin frame_id if it holds page_id and has no I/O in flight, without taking the latch.
+   * @param frame_id frame that a lock-free page table lookup mapped page_id to
+   * @param page_id id of the page to pin
+   * @return true if the frame was pinned and holds page_id; false, with the pin count unchanged, otherwise
+   */
+  auto TryPinFrame(frame_id_t frame_id, page_id_t page_id) -> bool;
+
+  /**
+   * @brief Pin an unpinned frame for a write-back and mark it io_in_progress_, so that nobody else pins it, and thus
+   * nobody changes its page, until the write is done. Caller must hold the latch.
+   * @return false if the frame is pinned or claimed already
+   */
+  auto ClaimForWriteBack(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Pick a frame to hold a new page, from the free list first and the replacer second, and claim it by setting
+   * its pin count to -1. The frame's old page stays in the page table until LoadFrame() has written it back. Caller
+   * must hold the latch.
+   * @param[out] frame_id the chosen frame
+   * @param[out] raced set to true if an evictable frame was skipped because a lock-free fetch had just pinned it
+   * @return false if every frame is pinned
+   */
+  auto GetVictimFrame(frame_id_t *frame_id, bool *raced) -> bool;
+
+  /**
+   * @brief Map page_id to frame_id, pin the frame once and mark it io_in_progress_. A dirty old page keeps its mapping
+   * until it is on disk; the caller writes it back and erases the mapping. Caller must hold the latch.
+   * @param frame_id frame claimed by GetVictimFrame()
+   * @param page_id id of the page to place in the frame
+   * @param access_type type of the access that brings the page in, recorded in the replacer
+   * @return the id of the old page that must be written back first, INVALID_PAGE_ID if there is none
+   */
+  auto InstallPage(frame_id_t frame_id, page_id_t page_id, AccessType access_type) -> page_id_t;
 
-  // TODO(student): You may add additional private members and helper functions
+  /**
+   * @brief Install page_id into frame_id and pin it once. If the frame's old page is dirty it is written back, and
+   * if `read` is set the new page is read from disk; both happen with the latch released while the frame is marked
+   * io_in_progress_. Caller must hold the latch through `lock`, and it is held again on return.
+   * @param lock the caller's lock on latch_
+   * @param frame_id frame claimed by GetVictimFrame()
+   * @param page_id id of the page to place in the frame
+   * @param read true to read the page from disk, false to start from a zeroed page
+   * @param access_type type of the access that brings the page in, recorded in the replacer
+   */
+  void LoadFrame(std::unique_lock<std::mutex> &lock, frame_id_t frame_id, page_id_t page_id, bool read,
+                 AccessType access_type);
+
+  /**
+   * @brief One step of PrefetchPages(): load page_id into this shard, then continue the chain through `pool`.
+   * @param pool the buffer pool that the read-ahead was started on, which routes later pages to their shards and
+   * counts the reads in flight
+   */
+  void PrefetchChain(page_id_t page_id, size_t count, const NextPageIdFunc &next_page_id, BufferPoolManager *pool);
+
+  /**
+   * @brief Append the resident pages of this shard to pages, hottest first, see DumpHotSet().
+   * @param[out] pages the hot set
+   */
+  void CollectHotPages(std::vector<HotPage> *pages);
+
+  /**
+   * @brief Load the pages of a hot set that belong to this shard, hottest first, see LoadHotSet(). The pages stay
+   * pinned until all of them are in, and are then unpinned coldest first, which rebuilds their recency order.
+   * @param pages the hot set, hottest first
+   * @return the number of pages loaded
+   */
+  auto LoadHotPages(const std::vector<HotPage> &pages) -> size_t;
+
+  /** Main loop of the hot set dumper. */
+  void RunHotSetDumps(const std::string &path);
+
+  /** Main loop of the background writer. */
+  void RunBackgroundWriter();
+
+  /**
+   * @brief One round of the background writer. Dirty frames among the next victims are claimed and marked clean
+   * under the latch, then written back without it.
+   * @return the number of pages written back
+   */
+  auto WriteBackColdPages() -> size_t;
+
+  /**
+   * @brief Write back the dirty or pinned pages of this shard with ids in [first_page_id, last_page_id), without
+   * syncing, see WriteBackFrames().
+   */
+  void WriteBackPages(page_id_t first_page_id, page_id_t last_page_id);
+
+  /**
+   * @brief Write back the pages held by frame_ids, which have no I/O in flight, without the latch. Unpinned frames
+   * are claimed for the write; frames in use are pinned and written under their page read latch, so that the image
+   * on disk is never torn. Caller must hold the latch through `lock`, and it is held again on return.
+   */
+  void WriteBackFrames(std::unique_lock<std::mutex> &lock, const std::vector<frame_id_t> &frame_ids);
+
+  /**
+   * @brief Sort pages by page id, hand runs of adjacent ones to the disk scheduler as vectored writes and wait for
+   * them all.
+   * @param pages (page id, frame data) of each page to write
+   */
+  void WritePageRuns(std::vector<std::pair<page_id_t, const char *>> *pages);
+
+  /**
+   * @brief Sort pages by page id, hand runs of adjacent ones to the disk scheduler as vectored reads and wait for
+   * them all.
+   * @param pages (page id, frame data) of each page to read
+   */
+  void ReadPageRuns(std::vector<std::pair<page_id_t, char *>> *pages);
+
+  /** @brief Shrink the pool to new_size frames, see Resize(). Caller must hold resize_latch_. */
+  void ShrinkTo(size_t new_size);
+
+  /**
+   * @brief Retire the unpinned frames in [first_frame_id, last_frame_id), writing back the dirty ones without the
+   * latch. Frames that are pinned or claimed for I/O are left alone.
+   * @return true if every frame in the range is retired
+   */
+  auto RetireFrames(frame_id_t first_frame_id, frame_id_t last_frame_id) -> bool;
 };
 }  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.h
+//
+// Identification: src/include/buffer/buffer_pool_metrics.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/metrics.h"
+
+namespace bustub {
+
+/** Number of AccessType values; metrics that depend on the access are kept once per type. */
+static constexpr size_t NUM_ACCESS_TYPES = 3;
+
+/** A point-in-time copy of the metrics of a buffer pool, see BufferPoolManager::GetMetrics(). */
+struct BufferPoolMetricsSnapshot {
+  /** Fetches of a resident page, by AccessType. */
+  std::array<uint64_t, NUM_ACCESS_TYPES> hits_{};
+  /** Fetches that had to read the page from disk, by AccessType. */
+  std::array<uint64_t, NUM_ACCESS_TYPES> misses_{};
+  /** Time from finding a miss to having the page in a frame, including any write-back, by AccessType. */
+  std::array<HistogramSnapshot, NUM_ACCESS_TYPES> miss_latency_{};
+  /** Pages created by NewPage(). */
+  uint64_t new_pages_{0};
+  /** Pages pushed out of a frame by the replacer. */
+  uint64_t evictions_{0};
+  /** Dirty victims written back before their frame could be reused. */
+  uint64_t dirty_write_backs_{0};
+  /** Time to write back a dirty victim. */
+  HistogramSnapshot write_back_latency_;
+  /** Dirty pages written back by the background writer. */
+  uint64_t background_writes_{0};
+  /** Pages read by read-ahead, or to warm the pool up with a hot set. */
+  uint64_t prefetches_{0};
+  /** Times a thread had to wait for I/O on a frame, or for a lock-free fetch to give a frame back. */
+  uint64_t pin_waits_{0};
+
+  /** @brief Add the metrics of another buffer pool (e.g. another shard) to these. */
+  void Merge(const BufferPoolMetricsSnapshot &other);
+
+  /** @return the fraction of fetches that were hits, 0 if there were none */
+  auto HitRatio() const -> double;
+
+  /** @return (name, value) pairs of all metrics, for display */
+  auto ToRows() const -> std::vector<std::pair<std::string, std::string>>;
+};
+
+/**
+ * The live counters behind BufferPoolMetricsSnapshot. The hit counters are bumped on the lock-free fetch path, so all
+ * counters are sharded; latencies are only timed around I/O.
+ */
+struct BufferPoolMetrics {
+  std::array<ShardedCounter, NUM_ACCESS_TYPES> hits_;
+  std::array<ShardedCounter, NUM_ACCESS_TYPES> misses_;
+  std::array<LatencyHistogram, NUM_ACCESS_TYPES> miss_latency_;
+  ShardedCounter new_pages_;
+  ShardedCounter evictions_;
+  ShardedCounter dirty_write_backs_;
+  LatencyHistogram write_back_latency_;
+  ShardedCounter background_writes_;
+  ShardedCounter prefetches_;
+  ShardedCounter pin_waits_;
+
+  /** @return a copy of the current values */
+  auto Snapshot() const -> BufferPoolMetricsSnapshot;
+};
+
+/** @return the index of access_type in the per-access-type metrics */
+inline auto AccessTypeIndex(AccessType access_type) -> size_t { return static_cast<size_t>(access_type); }
+
+}  // namespace bustub
@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -23,6 +22,10 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every tracked frame has a reference bit that is set when the frame is accessed. The clock hand sweeps over the
+ * frames, clearing reference bits, and evicts the first evictable frame whose bit is already clear. Scan accesses do
+ * not set the reference bit, so a frame that has only been scanned is evicted the first time the hand reaches it.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -37,16 +40,38 @@ class ClockReplacer : public Replacer {
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
+  /** Same as Evict(). */
+  auto Victim(frame_id_t *frame_id) -> bool { return Evict(frame_id); }
+
+  /** Make a frame non-evictable. */
+  void Pin(frame_id_t frame_id) { SetEvictable(frame_id, false); }
+
+  /** Make a frame evictable and set its reference bit, tracking it first if needed. */
+  void Unpin(frame_id_t frame_id);
+
  private:
-  // TODO(student): implement me!
+  struct ClockSlot {
+    bool tracked_{false};
+    bool evictable_{false};
+    bool referenced_{false};
+  };
+
+  std::vector<ClockSlot> slots_;
+  size_t hand_{0};
+  size_t curr_size_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
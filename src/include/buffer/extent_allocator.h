@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator.h
+//
+// Identification: src/include/buffer/extent_allocator.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+class Page;
+
+/**
+ * ExtentAllocator creates the pages of one table or index. Instead of taking the next page id of the buffer pool,
+ * whose neighbours belong to whatever other object grew at the same time, it reserves extents of DISK_EXTENT_PAGES
+ * consecutive page ids (BufferPoolManager::AllocateExtent()) and hands them out in order. The pages of the object are
+ * thus adjacent on disk, and scans and read-ahead along them turn into long sequential reads.
+ *
+ * Pages freed by DeletePage() come first, though: while the buffer pool has any, no new extent is reserved, and once
+ * the current extent is used up the object takes its pages from BufferPoolManager::NewPage(), which reuses them one
+ * by one. Reuse keeps the file from growing, at the cost of placing those pages wherever the freed ones were.
+ *
+ * Handing out an id is a single compare-and-swap; only reserving the next extent takes a latch. A page that could not
+ * be created leaves a gap in its extent. Where the current extent ends is not persisted either: an object reopened
+ * after a restart starts a new extent, and the unused tail of the old one is left as a hole in its segment file.
+ */
+class ExtentAllocator {
+ public:
+  /** @param bpm the buffer pool the pages are created in */
+  explicit ExtentAllocator(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  DISALLOW_COPY_AND_MOVE(ExtentAllocator);
+
+  /**
+   * @brief Create the next page of the current extent, reserving a new extent once it is used up.
+   * @param[out] page_id id of the created page
+   * @return nullptr if the buffer pool has no frame for the page, otherwise the pinned new page
+   */
+  auto NewPage(page_id_t *page_id) -> Page *;
+
+  /** @brief PageGuard wrapper for NewPage(). */
+  auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
+
+ private:
+  static auto Pack(page_id_t next_page_id, page_id_t extent_end) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(next_page_id)) << 32) | static_cast<uint32_t>(extent_end);
+  }
+  static auto NextOf(uint64_t extent) -> page_id_t { return static_cast<page_id_t>(extent >> 32); }
+  static auto EndOf(uint64_t extent) -> page_id_t { return static_cast<page_id_t>(extent & 0xFFFFFFFF); }
+
+  BufferPoolManager *bpm_;
+  /** The next page id to hand out and one past the last page id of the current extent, packed by Pack(). */
+  std::atomic<uint64_t> extent_{Pack(0, 0)};
+  /** Serializes reserving a new extent. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameArena holds the data of every frame of a buffer pool in one contiguous, zero-filled mapping. Frame i starts at
+ * offset i * BUSTUB_PAGE_SIZE and is aligned to BUSTUB_PAGE_SIZE, so it can be the target of O_DIRECT I/O.
+ *
+ * Arenas of at least HUGE_PAGE_SIZE bytes are backed by huge pages when USE_HUGE_PAGES is set: explicit ones if the
+ * system has reserved any, transparent ones otherwise. This keeps the TLB footprint of a large pool small.
+ *
+ * Memory is only committed when a frame is first touched, so an arena may reserve room for more frames than a buffer
+ * pool uses, and hand frames back to the OS with Discard() when the pool shrinks.
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief Map the frames of a buffer pool.
+   * @param num_frames the number of frames, may be 0
+   * @param discardable whether frames will be handed back with Discard(). Explicit huge pages are committed up front
+   * and cannot be handed back, so such an arena only uses transparent ones
+   * @throws Exception if the memory cannot be mapped
+   */
+  explicit FrameArena(size_t num_frames, bool discardable = false);
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  ~FrameArena();
+
+  /** @return the data of frame frame_id */
+  auto GetFrame(frame_id_t frame_id) const -> char * {
+    return data_ + static_cast<size_t>(frame_id) * BUSTUB_PAGE_SIZE;
+  }
+
+  /**
+   * @brief Give the memory of some frames back to the OS. They read as zeros when they are touched again.
+   * @param first_frame_id the first frame to discard
+   * @param num_frames the number of frames to discard
+   */
+  void Discard(frame_id_t first_frame_id, size_t num_frames);
+
+  /** @return true if the arena is mapped with explicit huge pages */
+  auto HasHugePages() const -> bool { return huge_pages_; }
+
+ private:
+  char *data_{nullptr};
+  /** Size of the mapping in bytes, rounded up to whole huge pages if it uses them. */
+  size_t size_{0};
+  bool huge_pages_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hot_set_file.h
+//
+// Identification: src/include/buffer/hot_set_file.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** One resident page of a buffer pool and what its replacer remembers about it. */
+struct HotPage {
+  page_id_t page_id_;
+  /** Accesses the replacer counted, see AccessHistory. */
+  uint32_t accesses_;
+  /** True if every access was a scan. */
+  bool scan_;
+};
+
+/**
+ * HotSetFile stores the hot set of a buffer pool, its resident pages from hottest to coldest, so that a restarted
+ * buffer pool can load them before it serves traffic (see BufferPoolManager::DumpHotSet()).
+ *
+ * The file starts with a magic number and the number of pages, followed by one fixed-size record per page. It is
+ * written to a temporary file that is then renamed over the old one, so a crash mid-dump leaves the previous dump.
+ */
+class HotSetFile {
+ public:
+  /**
+   * @brief Write a hot set.
+   * @param path the file to write
+   * @param pages the pages, hottest first
+   * @return false if the file could not be written
+   */
+  static auto Write(const std::string &path, const std::vector<HotPage> &pages) -> bool;
+
+  /**
+   * @brief Read a hot set.
+   * @param path the file to read
+   * @param[out] pages the pages, hottest first
+   * @return false if the file does not exist or is not a complete hot set
+   */
+  static auto Read(const std::string &path, std::vector<HotPage> *pages) -> bool;
+
+ private:
+  static constexpr uint32_t MAGIC = 0x42485331;  // "BHS1"
+
+  /** On-disk layout of a HotPage. */
+  struct Record {
+    int32_t page_id_;
+    uint32_t accesses_;
+    uint32_t scan_;
+  };
+};
+
+}  // namespace bustub
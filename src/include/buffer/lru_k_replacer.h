@@ -13,29 +13,33 @@
 #pragma once
 
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
-enum class AccessType { Unknown = 0, Get, Scan };
-
-// class LRUKNode {
-//  private:
-//   /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-//   // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
+/** Replacement book-keeping of one frame. LRUKReplacer keeps one per frame in an array indexed by frame id. */
+struct LRUKNode {
+  /** Number of recorded accesses, saturating at k. Zero if the frame is not tracked. */
+  size_t accesses_{0};
+  /** True if the frame may be evicted. Only evictable frames are linked into a list. */
+  bool evictable_{false};
+  /** True while every access to the frame has been a scan. Such frames sit at the tail of the history list. */
+  bool scan_{false};
+  /** Neighbours in the intrusive list the frame is linked into, -1 at either end. */
+  frame_id_t prev_{-1};
+  frame_id_t next_{-1};
+};
 
-//   std::list<size_t> history_;
-//   [[maybe_unused]] size_t k_;
-//   frame_id_t fid_;
-//   bool is_evictable_{false};
-//   LRUKNode(frame_id_t frame_id,bool evictable):fid_(frame_id),is_evictable_(evictable){}
-// };
+/** Head and tail of an intrusive doubly-linked list of LRUKNodes. Most recent frame at the head. */
+struct LRUKList {
+  frame_id_t head_{-1};
+  frame_id_t tail_{-1};
+};
 
 /**
  * LRUKReplacer implements the LRU-k replacement policy.
@@ -47,8 +51,16 @@ enum class AccessType { Unknown = 0, Get, Scan };
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multipe frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Frames with fewer than k accesses are kept in a history list in the order of their first access, and frames with k
+ * accesses in a cache list in the order of their last access. Both lists are intrusive, are threaded through a
+ * frame-indexed array of nodes, and hold evictable frames only, so every operation is O(1) and none allocates. A frame
+ * that becomes evictable again is linked in at the head of its list.
+ *
+ * Scan accesses do not count towards k, and a frame that has only been scanned is linked in at the tail of the
+ * history list, so it is the first to go.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
    *
@@ -66,7 +78,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -84,7 +96,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -99,7 +111,7 @@ class LRUKReplacer {
    * @param access_type type of access that was received. This parameter is only needed for
    * leaderboard tests.
    */
-  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown) override;
 
   /**
    * TODO(P1): Add implementation
@@ -118,7 +130,10 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  /** Link a non-evictable frame back in at the tail of its list, where Evict() takes it next. */
+  void ReturnVictim(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -137,7 +152,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -146,19 +161,37 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
+  /** @return the number of accesses (up to k) and the scan flag of frame_id */
+  auto GetHistory(frame_id_t frame_id) -> AccessHistory override;
+
+ protected:
+  /** @return true if frame_id has been accessed since it was last evicted or removed */
+  auto IsTracked(frame_id_t frame_id) -> bool;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> cache_hash_;    // 页在缓存中的位置
-  std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> history_hash_;  // 页在history中的位置
-
-  std::unordered_map<frame_id_t, size_t> records_;  // 访问次数
-  std::unordered_map<frame_id_t, bool> evictable_;  // 是否可驱逐
-  std::list<frame_id_t> cache_;                     // 缓存
-  std::list<frame_id_t> history_;
-  size_t curr_size_{0};  // 可驱逐页的数量
+  /** @return the list an evictable frame with this node belongs to */
+  auto ListOf(const LRUKNode &node) -> LRUKList & { return node.accesses_ >= k_ ? cache_ : history_; }
+
+  /** Link frame_id in at the head of list. */
+  void PushFront(LRUKList &list, frame_id_t frame_id);
+
+  /** Link frame_id in at the tail of list. */
+  void PushBack(LRUKList &list, frame_id_t frame_id);
+
+  /** Link an evictable frame into its list: at the tail if it has only been scanned, at the head otherwise. */
+  void Link(frame_id_t frame_id);
+
+  /** Unlink frame_id from list. */
+  void Unlink(LRUKList &list, frame_id_t frame_id);
+
+  std::vector<LRUKNode> nodes_;  // 每个帧的记录, 按帧号索引
+  LRUKList history_;             // 访问不足 k 次的可驱逐帧
+  LRUKList cache_;               // 访问满 k 次的可驱逐帧
+  size_t curr_size_{0};          // 可驱逐页的数量
   size_t replacer_size_;
   size_t k_;
   std::mutex latch_;  // 全局大锁
@@ -12,19 +12,16 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
-#include <vector>
-
-#include "buffer/replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "common/config.h"
 
 namespace bustub {
 
 /**
- * LRUReplacer implements the Least Recently Used replacement policy.
+ * LRUReplacer implements the Least Recently Used replacement policy. It is the k = 1 case of LRU-K, including its
+ * treatment of scans: frames that have only been scanned are evicted first.
  */
-class LRUReplacer : public Replacer {
+class LRUReplacer : public LRUKReplacer {
  public:
   /**
    * Create a new LRUReplacer.
@@ -37,16 +34,14 @@ class LRUReplacer : public Replacer {
    */
   ~LRUReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
-
-  void Pin(frame_id_t frame_id) override;
-
-  void Unpin(frame_id_t frame_id) override;
+  /** Same as Evict(). */
+  auto Victim(frame_id_t *frame_id) -> bool { return Evict(frame_id); }
 
-  auto Size() -> size_t override;
+  /** Make a frame non-evictable. */
+  void Pin(frame_id_t frame_id) { SetEvictable(frame_id, false); }
 
- private:
-  // TODO(student): implement me!
+  /** Make a frame evictable, tracking it as the most recently used frame if it was not tracked yet. */
+  void Unpin(frame_id_t frame_id);
 };
 
 }  // namespace bustub
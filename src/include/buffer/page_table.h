@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps page ids to the frames that hold them. It is a fixed-capacity, open-addressed hash table with linear
+ * probing, sized from the number of frames so that it never needs to grow. Each slot is a single 64-bit word holding
+ * both the page id and the frame id, so a lookup touches as few cache lines as possible.
+ *
+ * Writers (Insert / Erase) must be serialized by the caller, which for the buffer pool means holding its latch.
+ * Find() takes no lock and may run concurrently with a writer. It never returns a mapping that was not present at some
+ * point, but it can miss an entry that a concurrent Erase() is shifting backwards, and it can return an entry that is
+ * being erased. Lock-free callers must therefore validate the frame they get and fall back to a locked lookup when
+ * Find() fails.
+ */
+class PageTable {
+ public:
+  /**
+   * @brief Create a page table for a buffer pool of the given size.
+   * @param num_frames the number of frames in the buffer pool
+   */
+  explicit PageTable(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  ~PageTable() = default;
+
+  /**
+   * @brief Look up the frame holding page_id. Safe to call without holding the writer lock.
+   * @param page_id id of the page to look up
+   * @param[out] frame_id the frame mapped to page_id
+   * @return true if a mapping was found
+   */
+  auto Find(page_id_t page_id, frame_id_t *frame_id) const -> bool;
+
+  /**
+   * @brief Map page_id to frame_id. page_id must not already be in the table. Caller must hold the writer lock.
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of page_id. Caller must hold the writer lock.
+   * @return false if page_id was not in the table
+   */
+  auto Erase(page_id_t page_id) -> bool;
+
+  /** @return the number of mappings in the table. Caller must hold the writer lock. */
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  /** Page id -1 (INVALID_PAGE_ID) is never stored, so its encoding marks an empty slot. */
+  static constexpr uint64_t EMPTY_SLOT = ~uint64_t{0};
+
+  static auto Pack(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto PageOf(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto FrameOf(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the first slot probed for page_id */
+  auto Home(page_id_t page_id) const -> size_t;
+
+  /** Slot index of page_id, or capacity_ if absent. Caller must hold the writer lock. */
+  auto SlotOf(page_id_t page_id) const -> size_t;
+
+  size_t capacity_;
+  size_t mask_;
+  size_t size_{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+};
+
+}  // namespace bustub
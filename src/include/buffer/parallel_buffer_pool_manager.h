@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager splits the buffer pool into independent BufferPoolManager shards. Each shard has its own
+ * latch, page table, free list and replacer, and owns the page ids congruent to its index modulo the number of
+ * shards, so threads that touch different pages rarely contend on the same latch.
+ *
+ * It exposes the same interface as BufferPoolManager and can be passed anywhere a BufferPoolManager * is expected.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of shards
+   * @param pool_size the size of each shard
+   * @param disk_manager the disk manager shared by all shards
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each shard
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of each shard
+   * @param max_pool_size the largest size Resize() may grow each shard to, 0 for pool_size
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRUK, size_t max_pool_size = 0);
+
+  ~ParallelBufferPoolManager() override;
+
+  /** @brief Return the total number of frames across all shards. */
+  auto GetPoolSize() -> size_t override;
+
+  /** @brief Return the total number of frames all shards can grow to. */
+  auto GetMaxPoolSize() -> size_t override;
+
+  /**
+   * @brief Resize every shard, one after the other, spreading new_size over them as evenly as possible.
+   * @return false if some shard cannot take its share (every shard needs at least one frame)
+   */
+  auto Resize(size_t new_size) -> bool override;
+
+  /**
+   * @brief Create a new page in one of the shards. Shards are tried in round-robin order, starting one past the shard
+   * that served the previous call, so new pages spread evenly over the pool.
+   * @param[out] page_id id of created page
+   * @return nullptr if every shard is full of pinned pages, otherwise pointer to new page
+   */
+  auto NewPage(page_id_t *page_id) -> Page * override;
+
+  /**
+   * @brief Reserve an extent past the page ids of every shard. Shards stop allocating meanwhile, and the ids a shard
+   * skips on its way past the extent go on its free list. Returns INVALID_PAGE_ID while any shard has free pages.
+   */
+  auto AllocateExtent() -> page_id_t override;
+
+  /** @brief Create the page in the shard that owns page_id. */
+  auto NewPageAt(page_id_t page_id) -> Page * override;
+
+  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page * override;
+
+  /** @brief Split the batch by shard and fetch each part from the shard that owns it. */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<Page *> override;
+
+  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool override;
+
+  auto FlushPage(page_id_t page_id) -> bool override;
+
+  /** @brief Flush every shard, then sync the database file once. */
+  void FlushAllPages() override;
+
+  /** @brief Flush the pages in the range from every shard, then sync the database file once. */
+  void FlushDirtyPages(page_id_t first_page_id, page_id_t last_page_id) override;
+
+  auto DeletePage(page_id_t page_id) -> bool override;
+
+  /** @brief Start a background writer in every shard, each keeping its share of clean_target frames clean. */
+  void StartBackgroundWriter(size_t clean_target, size_t max_writes_per_round) override;
+
+  void StopBackgroundWriter() override;
+
+  /** @brief Read ahead along a chain of pages, each of which is loaded by the shard that owns it. */
+  void PrefetchPages(page_id_t page_id, size_t count, const NextPageIdFunc &next_page_id) override;
+
+  /** @brief Dump the hot sets of all shards as one, interleaving them so that the hottest pages of each come first. */
+  auto DumpHotSet(const std::string &path) -> bool override;
+
+  /** @brief Load a hot set, each page into the shard that owns it. */
+  auto LoadHotSet(const std::string &path) -> size_t override;
+
+  /** @return the metrics of all shards added up */
+  auto GetMetrics() -> BufferPoolMetricsSnapshot override;
+
+  /**
+   * @param page_id id of the page
+   * @return the shard responsible for page_id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager *;
+
+ private:
+  /** The shards, indexed by page id modulo their number. */
+  std::vector<std::unique_ptr<BufferPoolManager>> instances_;
+  /** Shard that NewPage() tries first. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.h
+//
+// Identification: src/include/buffer/read_ahead.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * ReadAheadWindow decides how far ahead of itself a scan along a chain of pages prefetches. A scan that never leaves
+ * its first page reads nothing ahead. Once it moves on, it prefetches READ_AHEAD_MIN_PAGES pages, and every time it
+ * has consumed half of what it requested it asks for more with a window twice as large, up to READ_AHEAD_MAX_PAGES.
+ * Short scans thus waste little I/O while long ones quickly keep many reads in flight.
+ */
+class ReadAheadWindow {
+ public:
+  /**
+   * @brief Record that the scan moved on to the next page of its chain.
+   * @return the number of pages to prefetch, starting at the page the scan moved to; 0 if enough pages are still
+   * ahead of it
+   */
+  auto Advance() -> size_t;
+
+  /** @return the current window size in pages */
+  auto GetWindow() const -> size_t { return window_; }
+
+ private:
+  /** Size of the last read-ahead, 0 before the first one. */
+  size_t window_{0};
+  /** Pages requested so far that the scan has not reached yet, counting the page it is on. */
+  size_t ahead_{0};
+};
+
+}  // namespace bustub
@@ -12,12 +12,33 @@
 
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+enum class AccessType { Unknown = 0, Get, Scan };
+
+/** What a replacer remembers about the accesses to a frame, see Replacer::GetHistory(). */
+struct AccessHistory {
+  /** Number of accesses the policy counts, 0 if it keeps no count or does not track the frame. */
+  size_t accesses_{0};
+  /** True if every access was a scan. */
+  bool scan_{false};
+};
+
+/** The replacement policies a BufferPoolManager can be built with. */
+enum class ReplacerType { LRUK = 0, LRU, Clock };
+
 /**
  * Replacer is an abstract class that tracks page usage.
+ *
+ * A frame is tracked from its first RecordAccess() until it is evicted or removed, and only evictable frames are
+ * candidates for eviction. Implementations are scan-resistant: frames touched only by AccessType::Scan accesses are
+ * evicted before frames that were accessed in any other way, so a large sequential scan cannot flush the pages that
+ * point lookups keep hot.
  */
 class Replacer {
  public:
@@ -29,22 +50,52 @@ class Replacer {
    * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
    * @return true if a victim frame was found, false otherwise
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * Record an access to a frame, and start tracking it as an evictable frame if it was not tracked yet.
+   * @param frame_id the id of the frame that was accessed
+   * @param access_type the kind of access
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * Mark a tracked frame as evictable or not. Does nothing for a frame that is not tracked.
+   * @param frame_id the id of the frame
+   * @param set_evictable whether the frame may be evicted
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+  /**
+   * Make a frame evictable again that was marked non-evictable right after PeekVictims() reported it, without
+   * counting an access: it goes back to the cold end of the eviction order instead of counting as just used.
+   * @param frame_id the id of the frame
+   */
+  virtual void ReturnVictim(frame_id_t frame_id) { SetEvictable(frame_id, true); }
+
+  /**
+   * Stop tracking a frame, no matter where the policy would place it. Does nothing for a frame that is not tracked.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
 
   /** @return the number of elements in the replacer that can be victimized */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * Collect the frames that Evict() would pick next, without evicting them.
+   * @param max_frames the maximum number of frames to collect
+   * @param[out] frame_ids the frames, in eviction order
+   */
+  virtual void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) = 0;
+
+  /**
+   * Report the access history of a frame, so that it can be replayed with RecordAccess() after a restart. Policies
+   * that keep no count report nothing.
+   * @param frame_id the id of the frame
+   * @return the history of the frame
+   */
+  virtual auto GetHistory([[maybe_unused]] frame_id_t frame_id) -> AccessHistory { return {}; }
 };
 
 }  // namespace bustub
@@ -262,6 +262,8 @@ class BustubInstance {
   Catalog *catalog_;
   ExecutionEngine *execution_engine_;
   std::shared_mutex catalog_lock_;
+  /** File that the buffer pool's hot set is dumped to and warmed up from, empty for an in-memory instance. */
+  std::string hot_set_file_name_;
 
   auto GetSessionVariable(const std::string &key) -> std::string {
     if (session_variables_.find(key) != session_variables_.end()) {
@@ -21,21 +21,46 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** When it is started, the background writer of the buffer pool runs every BG_WRITER_INTERVAL milliseconds. */
+extern std::chrono::milliseconds bg_writer_interval;
+
+/** When they are started, the hot set of the buffer pool is dumped every HOT_SET_DUMP_INTERVAL milliseconds. */
+extern std::chrono::milliseconds hot_set_dump_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** Page size of the build, set with `cmake -DBUSTUB_PAGE_SIZE=<bytes>`. Every page layout is derived from it. */
+#ifndef BUSTUB_PAGE_SIZE_BYTES
+#define BUSTUB_PAGE_SIZE_BYTES 4096
+#endif
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int BUSTUB_PAGE_SIZE = BUSTUB_PAGE_SIZE_BYTES;                      // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int DISK_SCHEDULER_WORKERS = 4;  // number of threads executing disk requests
+static constexpr int READ_AHEAD_MIN_PAGES = 4;    // read-ahead window of a scan once it turns out to be sequential
+static constexpr int READ_AHEAD_MAX_PAGES = 32;   // largest read-ahead window of a scan
+static constexpr int DISK_EXTENT_PAGES = 64;      // files grow, and tables and indexes take pages, this many at a time
+static constexpr int SEGMENT_FILE_PAGES = (1 << 30) / BUSTUB_PAGE_SIZE;  // pages per segment file (1 GiB)
+static constexpr int WRITE_BACK_MAX_RUN_PAGES = 64;  // most adjacent pages a write-back merges into one write
+static constexpr int READ_MAX_RUN_PAGES = 64;        // most adjacent pages a batched fetch merges into one read
+static constexpr int FETCH_BATCH_MAX_RIDS = 32;      // most RIDs an executor resolves with one batched fetch
+static constexpr bool USE_HUGE_PAGES = true;       // back large buffer pools with huge pages where the OS allows it
+static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;  // size of a huge page in bytes
+
+// Frames are aligned to the page size for O_DIRECT, and table pages address tuples with 16-bit offsets.
+static_assert(BUSTUB_PAGE_SIZE >= 4096 && BUSTUB_PAGE_SIZE <= 65536 && (BUSTUB_PAGE_SIZE & (BUSTUB_PAGE_SIZE - 1)) == 0,
+              "BUSTUB_PAGE_SIZE must be a power of two between 4 KiB and 64 KiB");
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
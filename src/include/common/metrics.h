@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics.h
+//
+// Identification: src/include/common/metrics.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ShardedCounter is a counter that many threads can bump at once without fighting over a cache line. Each thread adds
+ * to one of NUM_SHARDS padded slots; reading the counter sums them, so it is meant for statistics that are written
+ * much more often than read.
+ */
+class ShardedCounter {
+ public:
+  static constexpr size_t NUM_SHARDS = 16;
+
+  ShardedCounter() = default;
+  DISALLOW_COPY_AND_MOVE(ShardedCounter);
+
+  /** @brief Add n to the counter. */
+  void Add(uint64_t n = 1) { shards_[ShardIndex()].value_.fetch_add(n, std::memory_order_relaxed); }
+
+  /** @return the sum of all shards; concurrent additions may or may not be included */
+  auto Get() const -> uint64_t;
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  /** @return the shard of the calling thread; threads are spread over the shards round-robin */
+  static auto ShardIndex() -> size_t;
+
+  std::array<Shard, NUM_SHARDS> shards_;
+};
+
+/** A point-in-time copy of a LatencyHistogram. */
+struct HistogramSnapshot {
+  /** counts_[i] is the number of samples in [2^i, 2^(i+1)) nanoseconds; bucket 0 also holds samples of 0 ns. */
+  std::array<uint64_t, 40> counts_{};
+  uint64_t count_{0};
+  uint64_t sum_ns_{0};
+
+  /** @brief Add the samples of another snapshot to this one. */
+  void Merge(const HistogramSnapshot &other);
+
+  /** @return the mean latency in nanoseconds, 0 if there are no samples */
+  auto MeanNs() const -> uint64_t { return count_ == 0 ? 0 : sum_ns_ / count_; }
+
+  /**
+   * @param percentile a percentile in [0, 100]
+   * @return an upper bound (the end of its bucket) of the latency at that percentile in nanoseconds, 0 if empty
+   */
+  auto PercentileNs(double percentile) const -> uint64_t;
+
+  /** @return a one-line summary: count, mean, p50, p99 and max bucket */
+  auto ToString() const -> std::string;
+};
+
+/**
+ * LatencyHistogram records durations in power-of-two buckets of nanoseconds. Recording is lock-free and costs two
+ * relaxed atomic additions; it is meant for events that take at least a microsecond, like disk I/O.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram() = default;
+  DISALLOW_COPY_AND_MOVE(LatencyHistogram);
+
+  /** @brief Record one duration. */
+  void Record(std::chrono::nanoseconds duration);
+
+  /** @brief Record the time elapsed since start. */
+  void RecordSince(std::chrono::steady_clock::time_point start) { Record(std::chrono::steady_clock::now() - start); }
+
+  /** @return a copy of the current counts */
+  auto Snapshot() const -> HistogramSnapshot;
+
+ private:
+  std::array<std::atomic<uint64_t>, std::tuple_size_v<decltype(HistogramSnapshot::counts_)>> counts_{};
+  std::atomic<uint64_t> sum_ns_{0};
+};
+
+/** Records the lifetime of the object in a LatencyHistogram, so a function can time itself whichever way it returns. */
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram *histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  DISALLOW_COPY_AND_MOVE(ScopedLatency);
+  ~ScopedLatency() { histogram_->RecordSince(start_); }
+
+ private:
+  LatencyHistogram *histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
@@ -49,5 +50,10 @@ class IndexScanExecutor : public AbstractExecutor {
   IndexInfo *index_info_;
 
   BPlusTreeIndexIteratorForTwoIntegerColumn it_;
+
+  /** The tuples of the next RIDs from the index, in index order, read with one batched fetch. */
+  std::vector<std::pair<TupleMeta, Tuple>> batch_;
+  /** Position of the next tuple to return in batch_. */
+  size_t batch_pos_{0};
 };
 }  // namespace bustub
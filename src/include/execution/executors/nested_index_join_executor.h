@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -54,5 +55,18 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   IndexInfo *index_info_;
   TableInfo *table_info_;
   BPlusTreeIndexForTwoIntegerColumn *it_;
+
+  /**
+   * @brief Read the next batch of outer tuples and look up their matches, fetching the inner tuples together.
+   * @return false if the outer table is exhausted
+   */
+  auto NextBatch() -> bool;
+
+  /** The outer tuples of the current batch. */
+  std::vector<Tuple> left_tuples_;
+  /** For each outer tuple of the batch, its matching inner tuple if there is one. */
+  std::vector<std::optional<Tuple>> right_tuples_;
+  /** Position of the next outer tuple to join in the batch. */
+  size_t batch_pos_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager.h
+//
+// Identification: src/include/storage/disk/compressed_disk_manager.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * CompressedDiskManager is a DiskManager that stores every page compressed with PageCodec. The buffer pool still
+ * reads and writes whole uncompressed pages; only the bytes on disk shrink.
+ *
+ * The db file is divided into slots of one to SLOT_CLASSES units of SLOT_UNIT bytes, and a page takes the smallest
+ * slot its compressed image fits in (a page that does not compress below a full page is stored raw). Where each page
+ * lives is kept in a map file next to the db file (`<db_file>.map`): a header followed by one MapEntry per page id.
+ *
+ * A page is never rewritten in place. Each write goes to a fresh slot, taken from the free list of its size class or
+ * from the end of the file, and then the map entry is switched to it. The old slot is only reused after the next
+ * Sync(), so the last synced version of a page is never overwritten before the map that points to it is replaced.
+ */
+class CompressedDiskManager : public DiskManager {
+ public:
+  /** Number of slot sizes. */
+  static constexpr size_t SLOT_CLASSES = 8;
+  /** Slots are multiples of SLOT_UNIT bytes; the largest holds a raw page. */
+  static constexpr size_t SLOT_UNIT = BUSTUB_PAGE_SIZE / SLOT_CLASSES;
+
+  /**
+   * Opens (or creates) the db file and its page map, rebuilding the free space from the map.
+   * @param db_file the file name of the database file to write to
+   */
+  explicit CompressedDiskManager(const std::string &db_file);
+
+  ~CompressedDiskManager() override;
+
+  /** Make the pages and the page map durable, then release the slots of overwritten pages for reuse. */
+  void Sync() override;
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /** Pages are not contiguous on disk, so they are written one by one. */
+  void WritePages(page_id_t page_id, const std::vector<const char *> &pages_data) override;
+
+  /** Pages that were never written read as zeros. */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /** Pages are not contiguous on disk, so they are read one by one. */
+  void ReadPages(page_id_t page_id, const std::vector<char *> &pages_data) override;
+
+  /** @return bytes of the db file taken by live pages (their slots); the raw size is pages * BUSTUB_PAGE_SIZE */
+  auto GetStoredBytes() const -> uint64_t;
+
+  /** @return the number of pages stored in the db file */
+  auto GetNumStoredPages() const -> size_t;
+
+ private:
+  /** Where a page lives in the db file, as stored in the map file. */
+  struct MapEntry {
+    uint64_t offset_;
+    uint32_t size_;
+    uint32_t flags_;
+  };
+  static constexpr uint32_t PRESENT = 1;
+  static constexpr uint32_t COMPRESSED = 2;
+  static constexpr size_t MAP_HEADER_SIZE = 16;
+
+  /** Read the map file into map_ and rebuild file_end_ and the free lists from the gaps between slots. */
+  void LoadMap();
+  /** @return the offset of a free slot of slot_class units. Caller holds map_latch_. */
+  auto AllocateSlot(size_t slot_class) -> uint64_t;
+  /** Add the space [offset, offset + length) to the free lists. Caller holds map_latch_. */
+  void AddFreeSpace(uint64_t offset, uint64_t length);
+
+  std::string map_name_;
+  int map_fd_{-1};
+
+  /** Protects everything below. Page data I/O happens outside of it. */
+  mutable std::mutex map_latch_;
+  /** Location of each page, indexed by page id. */
+  std::vector<MapEntry> map_;
+  /** Offsets of free slots, by size class (units - 1). */
+  std::array<std::vector<uint64_t>, SLOT_CLASSES> free_slots_;
+  /** Slots (offset, units) of overwritten pages, freed by the next Sync(). */
+  std::vector<std::pair<uint64_t, size_t>> pending_free_;
+  /** End of the last slot ever allocated. */
+  uint64_t file_end_{0};
+  uint64_t stored_bytes_{0};
+  size_t stored_pages_{0};
+};
+
+}  // namespace bustub
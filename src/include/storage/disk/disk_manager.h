@@ -13,37 +13,71 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <future>  // NOLINT
+#include <limits>
+#include <memory>
 #include <mutex>   // NOLINT
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "common/metrics.h"
 
 namespace bustub {
 
+/** A point-in-time copy of the I/O statistics of a DiskManager, see DiskManager::GetMetrics(). */
+struct DiskMetricsSnapshot {
+  /** Page reads; the count of the histogram is the number of reads. */
+  HistogramSnapshot read_latency_;
+  /** Page writes. */
+  HistogramSnapshot write_latency_;
+  /** Sync() calls. */
+  HistogramSnapshot sync_latency_;
+
+  /** @return (name, value) pairs of all metrics, for display */
+  auto ToRows() const -> std::vector<std::pair<std::string, std::string>>;
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are read and written with positional I/O (pread / pwrite) on a file descriptor, so any number of threads can
+ * do page I/O at the same time without a latch. Writes are not synced one by one; call Sync() where durability is
+ * needed. ShutDown() syncs the database file before closing it.
+ *
+ * The pages are spread over segment files of SEGMENT_FILE_PAGES pages each: page p lives in segment p /
+ * SEGMENT_FILE_PAGES, at offset (p % SEGMENT_FILE_PAGES) * BUSTUB_PAGE_SIZE. Segment 0 is the database file itself,
+ * segment n > 0 is `<db_file>.<n>`, created by the first write to one of its pages.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io open the database file with O_DIRECT, bypassing the OS page cache. Falls back to buffered I/O if
+   * the file system does not support it
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
   void ShutDown();
 
+  /**
+   * Make every page written so far durable (fdatasync on the database file).
+   */
+  virtual void Sync();
+
   /**
    * Write a page to the database file.
    * @param page_id id of the page
@@ -51,6 +85,14 @@ class DiskManager {
    */
   virtual void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write consecutive pages to the database file with as few system calls (pwritev) as possible. Disk managers that
+   * do not keep the pages in the db file write them one by one with WritePage().
+   * @param page_id id of the first page
+   * @param pages_data raw data of pages page_id, page_id + 1, ...
+   */
+  virtual void WritePages(page_id_t page_id, const std::vector<const char *> &pages_data);
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -58,6 +100,33 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Read consecutive pages from the database file with as few system calls (preadv) as possible. Pages past the end
+   * of the file read as zeros. Disk managers that do not keep the pages in the db file read them one by one with
+   * ReadPage().
+   * @param page_id id of the first page
+   * @param[out] pages_data output buffers of pages page_id, page_id + 1, ...
+   */
+  virtual void ReadPages(page_id_t page_id, const std::vector<char *> &pages_data);
+
+  /**
+   * Write a metadata page. Metadata pages hold state of the layers above that has to survive a restart but has no
+   * page id of its own, like where the free page list of a buffer pool starts. They are kept in `<db_file>.meta`,
+   * which is discarded when the database file is created afresh, and synced by Sync(). Disk managers without a
+   * database file keep them in memory.
+   * @param index number of the metadata page
+   * @param page_data raw page data
+   */
+  void WriteMetaPage(uint32_t index, const char *page_data);
+
+  /**
+   * Read a metadata page.
+   * @param index number of the metadata page
+   * @param[out] page_data output buffer
+   * @return false if the page has never been written
+   */
+  auto ReadMetaPage(uint32_t index, char *page_data) -> bool;
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -83,6 +152,12 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return a snapshot of the latency histograms of page reads, page writes and syncs */
+  auto GetMetrics() const -> DiskMetricsSnapshot;
+
+  /** @return true if the database file was opened with O_DIRECT */
+  auto IsDirectIo() const -> bool { return segments_ != nullptr && segments_[0].direct_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,19 +168,68 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
-  auto GetFileSize(const std::string &file_name) -> int;
+  auto GetFileSize(const std::string &file_name) -> int64_t;
+
+  /** One file of the database, holding SEGMENT_FILE_PAGES consecutive pages. */
+  struct SegmentFile {
+    // descriptor of the file, -1 until it is opened and once it is closed
+    std::atomic<int> fd_{-1};
+    // size of the file, kept up to date by writes so that reads need no stat()
+    std::atomic<uint64_t> size_{0};
+    // bytes of disk space reserved for the file, see ReserveSpace()
+    std::atomic<uint64_t> reserved_{0};
+    // whether the file was opened with O_DIRECT; set before fd_ and never changed while the file is open
+    bool direct_{false};
+  };
+  static constexpr uint64_t SEGMENT_FILE_BYTES = static_cast<uint64_t>(SEGMENT_FILE_PAGES) * BUSTUB_PAGE_SIZE;
+  static constexpr size_t MAX_SEGMENT_FILES =
+      (static_cast<size_t>(std::numeric_limits<page_id_t>::max()) + 1) / SEGMENT_FILE_PAGES;
+
+  /**
+   * @param page_id a page
+   * @param create whether to create the segment file if it does not exist yet
+   * @return the open segment file holding page_id, nullptr if it does not exist (or cannot be opened)
+   */
+  auto GetSegment(page_id_t page_id, bool create) -> SegmentFile *;
+  /** @return the byte offset of page_id in its segment file */
+  static auto SegmentOffset(page_id_t page_id) -> uint64_t {
+    return static_cast<uint64_t>(page_id % SEGMENT_FILE_PAGES) * BUSTUB_PAGE_SIZE;
+  }
+  /** Open segment file `segment`. Caller holds db_io_latch_. */
+  auto OpenSegment(size_t segment, bool create) -> SegmentFile *;
+  /**
+   * Make sure disk space is reserved for a segment file up to `end` bytes. Space is reserved an extent at a time, at
+   * least DISK_EXTENT_PAGES pages and an eighth of the file, so consecutive pages tend to be physically adjacent.
+   * @param limit no space is reserved past this many bytes, unless end itself is past it
+   */
+  void ReserveSpace(SegmentFile *segment, uint64_t end, uint64_t limit = std::numeric_limits<uint64_t>::max());
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
   std::string file_name_;
+  // the segment files, indexed by segment number; segment 0 is the db file
+  std::unique_ptr<SegmentFile[]> segments_;
+  // one past the highest segment number ever opened
+  std::atomic<size_t> num_segments_{0};
+  // set by ShutDown(), after which no segment file is opened again
+  bool shut_down_{false};
+  // whether segment files are opened with O_DIRECT, cleared once the file system rejects it; guarded by db_io_latch_
+  bool direct_io_{false};
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
+  // I/O latencies, recorded by every implementation of ReadPage(), WritePage() and Sync()
+  LatencyHistogram read_latency_;
+  LatencyHistogram write_latency_;
+  LatencyHistogram sync_latency_;
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
+  // Protects opening and closing the segment files; page I/O itself needs no latch.
   std::mutex db_io_latch_;
+  // descriptor of `<db_file>.meta`, -1 if there is none, see WriteMetaPage()
+  std::atomic<int> meta_fd_{-1};
+  // metadata pages of disk managers without a database file
+  std::vector<std::unique_ptr<char[]>> meta_pages_;
+  std::mutex meta_latch_;
 };
 
 }  // namespace bustub
@@ -10,9 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 #include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
 #include <cstring>
 #include <fstream>
 #include <future>  // NOLINT
+#include <limits>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <optional>
@@ -58,71 +62,107 @@ class DiskManagerMemory : public DiskManager {
 };
 
 /**
- * DiskManagerMemory replicates the utility of DiskManager on memory. It is primarily used for
- * data structure performance testing.
+ * Latency model of the device that DiskManagerUnlimitedMemory simulates. The default model has no latency at all.
+ */
+struct DiskLatencyModel {
+  /** Time from issuing a request to its first byte, e.g. 100us for a flash drive. */
+  std::chrono::microseconds latency_{0};
+  /** Most requests the device serves at once; further requests queue up. 0 for no limit. */
+  size_t queue_depth_{0};
+  /** Bytes per second the device transfers, shared by all requests in flight. 0 for no limit. */
+  size_t bandwidth_{0};
+};
+
+/**
+ * DiskManagerUnlimitedMemory replicates the utility of DiskManager on memory, growing as pages are written. It is
+ * primarily used for data structure performance testing, so it must not become the bottleneck of a multi-threaded
+ * benchmark itself.
+ *
+ * Pages are found through a two-level directory: a fixed array of chunk pointers, each chunk holding the pointers of
+ * PAGES_PER_CHUNK pages. Chunks and pages are allocated on their first write and installed with a compare-and-swap,
+ * so lookups take no lock at all; only the page itself is latched while it is copied.
  */
 class DiskManagerUnlimitedMemory : public DiskManager {
  public:
-  DiskManagerUnlimitedMemory() = default;
+  DiskManagerUnlimitedMemory();
+
+  ~DiskManagerUnlimitedMemory() override;
 
   /**
    * Write a page to the database file.
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data) override {
-    if (latency_ > 0) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(latency_));
-    }
-
-    std::unique_lock<std::mutex> l(mutex_);
-    if (page_id >= static_cast<int>(data_.size())) {
-      data_.resize(page_id + 1);
-    }
-    if (data_[page_id] == nullptr) {
-      data_[page_id] = std::make_shared<ProtectedPage>();
-    }
-    std::shared_ptr<ProtectedPage> ptr = data_[page_id];
-    std::unique_lock<std::shared_mutex> l_page(ptr->second);
-    l.unlock();
-
-    memcpy(ptr->first.data(), page_data, BUSTUB_PAGE_SIZE);
-  }
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Write consecutive pages to the database file, as a single request of the latency model.
+   * @param page_id id of the first page
+   * @param pages_data raw data of each page
+   */
+  void WritePages(page_id_t page_id, const std::vector<const char *> &pages_data) override;
 
   /**
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data) override {
-    if (latency_ > 0) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(latency_));
-    }
-
-    std::unique_lock<std::mutex> l(mutex_);
-    if (page_id >= static_cast<int>(data_.size()) || page_id < 0) {
-      LOG_WARN("page not exist");
-      return;
-    }
-    if (data_[page_id] == nullptr) {
-      LOG_WARN("page not exist");
-      return;
-    }
-    std::shared_ptr<ProtectedPage> ptr = data_[page_id];
-    std::shared_lock<std::shared_mutex> l_page(ptr->second);
-    l.unlock();
-
-    memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
-  }
-
-  void SetLatency(size_t latency_ms) { latency_ = latency_ms; }
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Read consecutive pages from the database file, as a single request of the latency model.
+   * @param page_id id of the first page
+   * @param[out] pages_data output buffer of each page
+   */
+  void ReadPages(page_id_t page_id, const std::vector<char *> &pages_data) override;
+
+  /** @brief Make every request take latency_ms milliseconds, with no limit on queue depth or bandwidth. */
+  void SetLatency(size_t latency_ms);
+
+  /** @brief Simulate a device with the given latency, queue depth and bandwidth. */
+  void SetLatencyModel(const DiskLatencyModel &model);
 
  private:
-  std::mutex mutex_;
-  using Page = std::array<char, BUSTUB_PAGE_SIZE>;
-  using ProtectedPage = std::pair<Page, std::shared_mutex>;
-  std::vector<std::shared_ptr<ProtectedPage>> data_;
-  size_t latency_{0};
+  static constexpr size_t PAGES_PER_CHUNK = 1 << 16;
+  /** Enough chunks for every non-negative page id. */
+  static constexpr size_t MAX_CHUNKS =
+      (static_cast<size_t>(std::numeric_limits<page_id_t>::max()) + 1) / PAGES_PER_CHUNK;
+
+  struct ProtectedPage {
+    std::shared_mutex latch_;
+    std::array<char, BUSTUB_PAGE_SIZE> data_;
+  };
+  using Chunk = std::array<std::atomic<ProtectedPage *>, PAGES_PER_CHUNK>;
+
+  /**
+   * @param page_id id of the page
+   * @param create true to allocate the page (and its chunk) if it does not exist yet
+   * @return the page, nullptr if it does not exist and create is false
+   */
+  auto GetPage(page_id_t page_id, bool create) -> ProtectedPage *;
+
+  /** @brief Copy page_data into the page, without the latency of the model. */
+  void CopyIn(page_id_t page_id, const char *page_data);
+
+  /** @brief Copy the page into page_data, without the latency of the model. */
+  void CopyOut(page_id_t page_id, char *page_data);
+
+  /** @brief Wait as long as the latency model says a request for num_pages pages takes. */
+  void Delay(size_t num_pages);
+
+  /** The chunk directory, MAX_CHUNKS entries. */
+  std::unique_ptr<std::atomic<Chunk *>[]> chunks_;
+
+  /** True if the latency model delays requests at all, so that a model-free run never takes model_latch_. */
+  std::atomic<bool> delay_{false};
+  /** Protects model_, in_flight_ and channel_free_. */
+  std::mutex model_latch_;
+  std::condition_variable model_cv_;
+  DiskLatencyModel model_;
+  /** Requests being served by the simulated device. */
+  size_t in_flight_{0};
+  /** When the simulated device finishes the transfers scheduled so far. */
+  std::chrono::steady_clock::time_point channel_free_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <future>  // NOLINT
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/channel.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief Represents a Write or Read request for the DiskManager to execute.
+ */
+struct DiskRequest {
+  /** Flag indicating whether the request is a write or a read. */
+  bool is_write_;
+
+  /**
+   *  Pointer to the start of the memory location where a page is either:
+   *   1. being read into from disk (on a read).
+   *   2. being written out to disk (on a write).
+   */
+  char *data_;
+
+  /** ID of the page being read from / written to disk. */
+  page_id_t page_id_;
+
+  /** Callback used to signal to the request issuer when the request has been completed. */
+  std::promise<bool> callback_;
+
+  /**
+   * Optional completion hook, run by the worker thread after the I/O and before callback_ is set. Issuers that do
+   * not want to wait for the request use it instead of the future.
+   */
+  std::function<void()> on_complete_{};
+
+  /**
+   * For a write of several consecutive pages, starting at page_id_: the data of each page, in order. data_ is not used
+   * then. Such a write goes to DiskManager::WritePages().
+   */
+  std::vector<const char *> pages_data_{};
+
+  /**
+   * For a read of several consecutive pages, starting at page_id_: the buffer of each page, in order. data_ is not
+   * used then. Such a read goes to DiskManager::ReadPages().
+   */
+  std::vector<char *> read_pages_data_{};
+};
+
+/**
+ * @brief The DiskScheduler schedules disk read and write operations.
+ *
+ * A request is scheduled by calling DiskScheduler::Schedule() with an appropriate DiskRequest object. A pool of
+ * worker threads takes requests off a shared queue and executes them with the DiskManager, so up to num_workers
+ * requests are in flight at once. Requests may complete in any order, even requests for the same page; an issuer
+ * that needs one request to finish before another starts waits for the first one's future.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * @brief Creates a DiskScheduler and starts its worker threads.
+   * @param disk_manager the disk manager that executes the requests
+   * @param num_workers the number of worker threads, i.e. the maximum number of requests in flight
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t num_workers = DISK_SCHEDULER_WORKERS);
+
+  /** @brief Finishes every request scheduled so far, then stops the worker threads. */
+  ~DiskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(DiskScheduler);
+
+  /**
+   * @brief Schedules a request for the DiskManager to execute.
+   *
+   * @param r The request to be scheduled.
+   */
+  void Schedule(DiskRequest r);
+
+  /**
+   * @brief Create a Promise object. If you want to implement your own version of promise, you can change this
+   * function so that our test cases can use your promise implementation.
+   *
+   * @return std::promise<bool>
+   */
+  using DiskSchedulerPromise = std::promise<bool>;
+  auto CreatePromise() -> DiskSchedulerPromise { return {}; };
+
+ private:
+  /**
+   * @brief Loop of a worker thread: takes requests off the queue and executes them until it receives std::nullopt.
+   */
+  void StartWorkerThread();
+
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** A shared queue to concurrently schedule and process requests. When the DiskScheduler's destructor is called,
+   * `std::nullopt` is put into the queue once per worker to signal the workers to stop execution. */
+  Channel<std::optional<DiskRequest>> request_queue_;
+  /** The worker threads, which execute the scheduled requests. */
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_list.h
+//
+// Identification: src/include/storage/disk/free_page_list.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/free_list_trunk_page.h"
+
+namespace bustub {
+
+/**
+ * FreePageList keeps track of deallocated pages so that they can be handed out again instead of growing the database
+ * file. It is stored in the free pages themselves, as a chain of FreeListTrunkPages (see there), plus one bit per page
+ * id to turn away pages that are freed twice. Flush() writes the trunks, after which the list can be found again from
+ * GetHeadPageId() and reopened with Open().
+ *
+ * Pop() and Push() never do I/O, since the buffer pool calls them under its latch. Trunks that have not been written
+ * yet stay in memory. When the list runs into a trunk that is only on disk, Pop() fails (the caller allocates a fresh
+ * page instead) until the caller has read it through StartHeadRead() and LoadHead().
+ *
+ * Pages are reused in LIFO order, so a page freed recently (and likely still near its neighbours) comes back first.
+ *
+ * FreePageList is not thread-safe; the buffer pool calls it under its latch.
+ */
+class FreePageList {
+ public:
+  /**
+   * @brief Create an empty free page list.
+   * @param disk_manager the disk manager that trunk pages are read from and written to
+   */
+  explicit FreePageList(DiskManager *disk_manager);
+
+  DISALLOW_COPY_AND_MOVE(FreePageList);
+
+  ~FreePageList() = default;
+
+  /**
+   * @brief Reopen a list that was written by Flush(). Reads the whole chain of trunks; pages are not checked for
+   * being free beyond that, so this is meant for a list that has just been created.
+   * @param head_page_id the head trunk, from GetHeadPageId()
+   * @param end_page_id page ids on the list are below it
+   * @return false if the chain is damaged, in which case the list is left empty
+   */
+  auto Open(page_id_t head_page_id, page_id_t end_page_id) -> bool;
+
+  /**
+   * @brief Take a free page off the list.
+   * @param[out] page_id the page, which the caller now owns
+   * @return false if the list is empty, or its head trunk has to be read first (see StartHeadRead())
+   */
+  auto Pop(page_id_t *page_id) -> bool;
+
+  /**
+   * @brief Put a page that is no longer used on the list.
+   * @return false if the page is on the list already, in which case it is not added again
+   */
+  auto Push(page_id_t page_id) -> bool;
+
+  /** @return true if the page is on the list */
+  auto Contains(page_id_t page_id) const -> bool {
+    return static_cast<size_t>(page_id) < listed_.size() && listed_[page_id];
+  }
+
+  /**
+   * @brief Ask for the head trunk to be read, once Pop() has moved on to a trunk that is only on disk.
+   * @return the page to read and pass to LoadHead(), or INVALID_PAGE_ID if there is none or it was asked for already
+   */
+  auto StartHeadRead() -> page_id_t;
+
+  /**
+   * @brief Install a trunk read from disk as the head. Ignored if the list has moved on since it was asked for.
+   * @param page_id the page from StartHeadRead()
+   * @param data the page's data
+   */
+  void LoadHead(page_id_t page_id, const char *data);
+
+  /** @brief Write every trunk that changed since it was last written. */
+  void Flush();
+
+  /** @return the number of free pages on the list, including trunk pages */
+  auto Size() const -> size_t { return size_; }
+
+  /** @return the head trunk page, where the list can be found on disk after Flush(); INVALID_PAGE_ID if it is empty */
+  auto GetHeadPageId() const -> page_id_t { return head_page_id_; }
+
+ private:
+  auto Head() -> FreeListTrunkPage * { return reinterpret_cast<FreeListTrunkPage *>(head_.get()); }
+
+  /** Mark a page as listed, growing listed_ as needed. */
+  void SetListed(page_id_t page_id);
+
+  DiskManager *disk_manager_;
+  page_id_t head_page_id_{INVALID_PAGE_ID};
+  /** In-memory copy of the head trunk page, valid if head_loaded_. */
+  std::unique_ptr<char[]> head_;
+  bool head_loaded_{true};
+  bool head_dirty_{false};
+  /** Set once StartHeadRead() has handed out the unloaded head. */
+  bool head_read_started_{false};
+  /** Full trunks behind the head that have not been written yet. */
+  std::unordered_map<page_id_t, std::unique_ptr<char[]>> unwritten_;
+  size_t size_{0};
+  /** Bit i is set while page i is on the list, trunk pages included. */
+  std::vector<bool> listed_;
+};
+
+}  // namespace bustub
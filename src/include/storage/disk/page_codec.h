@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_codec.h
+//
+// Identification: src/include/storage/disk/page_codec.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * PageCodec compresses a page with a small LZ77 codec in the style of LZ4: a sequence of (literals, back-reference)
+ * pairs found through a hash table of 4-byte prefixes. It is built for speed, not ratio, so that compressing a page
+ * costs a few microseconds; zeroed space, repeated values and small integers, which fill most table and index
+ * pages, shrink well.
+ *
+ * A compressed page is a list of sequences. Each starts with a token byte whose high nibble is the number of
+ * literals and whose low nibble is the match length minus MIN_MATCH; a nibble of 15 is continued by bytes that are
+ * added to it, up to and including the first one below 255. The literals follow, then the match offset as two
+ * little-endian bytes. The last sequence has literals only.
+ */
+class PageCodec {
+ public:
+  /** Shortest back-reference the codec emits. */
+  static constexpr size_t MIN_MATCH = 4;
+
+  /**
+   * @brief Compress a page.
+   * @param page the BUSTUB_PAGE_SIZE bytes to compress
+   * @param[out] out buffer for the compressed page
+   * @param capacity size of out; compression gives up once it would need more
+   * @return the size of the compressed page, 0 if it does not fit in capacity bytes
+   */
+  static auto Compress(const char *page, char *out, size_t capacity) -> size_t;
+
+  /**
+   * @brief Decompress a page compressed by Compress().
+   * @param in the compressed page
+   * @param size the size of the compressed page
+   * @param[out] page buffer for the BUSTUB_PAGE_SIZE bytes of the page
+   * @return false if in is not a valid compressed page
+   */
+  static auto Decompress(const char *in, size_t size, char *page) -> bool;
+};
+
+}  // namespace bustub
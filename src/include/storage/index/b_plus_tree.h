@@ -10,12 +10,14 @@
  */
 #pragma once
 
+#include <atomic>
 #include <deque>
 #include <iostream>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
+#include "buffer/extent_allocator.h"
 #include "common/config.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
@@ -98,6 +100,15 @@ class BPlusTree {
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
+  // Find the leaf that may hold key and read latch it. Returns nullopt if the tree is empty.
+  auto FindLeafRead(const KeyType &key) -> std::optional<ReadPageGuard>;
+
+  // Like FindLeafRead(), but without latching the header and inner pages. Returns false if a writer got in the way.
+  auto TryFindLeafOptimistic(const KeyType &key, std::optional<ReadPageGuard> *leaf) -> bool;
+
+  // Like TryFindLeafOptimistic(), but write latches the leaf, for inserts and removes that do not split or merge it.
+  auto TryFindLeafOptimisticWrite(const KeyType &key, std::optional<WritePageGuard> *leaf) -> bool;
+
   // Return the page id of the root node
   auto GetRootPageId() const -> page_id_t;
 
@@ -147,14 +158,39 @@ class BPlusTree {
    */
   auto ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTree;
 
+  // Descend to the leaf that may hold key without latching anything. Returns false if a writer got in the way, or too
+  // many other descents are running; leaf is left empty if the tree is.
+  auto TryDescendOptimistic(const KeyType &key, std::optional<OptimisticPageGuard> *leaf) -> bool;
+
+  auto DescendOptimistic(const KeyType &key, std::optional<OptimisticPageGuard> *leaf) -> bool;
+
+  // Pin and latch a page for a latch-crabbing pass, waiting for a frame if every frame is pinned for now.
+  auto FetchPageReadWait(page_id_t page_id) -> ReadPageGuard;
+
+  auto FetchPageWriteWait(page_id_t page_id) -> WritePageGuard;
+
+  // Create a page of this tree and write latch it, waiting for a frame like FetchPageWriteWait().
+  auto NewPageWriteWait(page_id_t *page_id) -> WritePageGuard;
+
+  // Optimistic descents to try before FindLeafRead() latches its way down.
+  static constexpr int OPTIMISTIC_READ_ATTEMPTS = 4;
+  // Optimistic descents an insert or remove tries before it write latches its way down from the header.
+  static constexpr int OPTIMISTIC_WRITE_ATTEMPTS = 2;
+  // At most one optimistic descent per this many frames of the pool runs at once.
+  static constexpr size_t FRAMES_PER_OPTIMISTIC_DESCENT = 8;
+
   // member variable
   std::string index_name_;
   BufferPoolManager *bpm_;
+  // Creates the pages of this tree from extents of its own, so they are adjacent on disk.
+  ExtentAllocator extents_;
   KeyComparator comparator_;
   std::vector<std::string> log;  // NOLINT
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  std::atomic<size_t> optimistic_descents_{0};
+  size_t max_optimistic_descents_;
 };
 
 /**
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 
 #include "storage/table/tuple.h"
@@ -19,6 +20,16 @@
 
 namespace bustub {
 
+/**
+ * Write the columns of a key tuple into out so that memcmp over out orders keys the way the column values compare.
+ *
+ * Integers and timestamps are written big-endian with the sign bit flipped, decimals with the IEEE sign trick, and a
+ * NULL fixed-width value keeps its sentinel, which sorts first. A varchar is a presence byte followed by its bytes
+ * with 0x00 escaped as 0x00 0xFF and a 0x00 0x00 terminator. Columns with their bit set in descending have their
+ * bytes inverted. The encoding is zero padded, or truncated if it does not fit in size bytes.
+ */
+void NormalizeKey(const Tuple &tuple, const Schema &key_schema, uint64_t descending, char *out, size_t size);
+
 /**
  * Generic key is used for indexing with opaque data.
  *
@@ -29,35 +40,33 @@ namespace bustub {
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
-    // intialize to 0
-    memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+  /**
+   * Normalize the key tuple into data_ so that keys order by memcmp; see NormalizeKey.
+   * @param descending bit i set sorts column i in descending order
+   */
+  inline void SetFromKey(const Tuple &tuple, const Schema &key_schema, uint64_t descending = 0) {
+    NormalizeKey(tuple, key_schema, descending, data_, KeySize);
   }
 
   // NOTE: for test purpose only
+  // encode key as a single bigint column
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
-  }
-
-  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
-    const char *data_ptr;
-    const auto &col = schema->GetColumn(column_idx);
-    const TypeId column_type = col.GetType();
-    const bool is_inlined = col.IsInlined();
-    if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
+    uint64_t bits = static_cast<uint64_t>(key) ^ (uint64_t{1} << 63);
+    for (size_t i = 0; i < sizeof(int64_t) && i < KeySize; i++) {
+      data_[i] = static_cast<char>(bits >> (56 - 8 * i));
     }
-    return Value::DeserializeFrom(data_ptr, column_type);
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline auto ToString() const -> int64_t { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // decode the first 8 bytes as a bigint written by SetFromInteger
+  inline auto ToString() const -> int64_t {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(int64_t) && i < KeySize; i++) {
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(data_[i])) << (56 - 8 * i);
+    }
+    return static_cast<int64_t>(bits ^ (uint64_t{1} << 63));
+  }
 
   // NOTE: for test purpose only
   // interpret the first 8 bytes as int64_t from data vector
@@ -77,30 +86,13 @@ template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
-    uint32_t column_count = key_schema_->GetColumnCount();
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
-      }
-    }
-    // equals
-    return 0;
+    // keys are normalized, so the byte order is the key order
+    int cmp = memcmp(lhs.data_, rhs.data_, KeySize);
+    return (cmp > 0) - (cmp < 0);
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
-
-  // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
-
- private:
-  Schema *key_schema_;
+  // constructor; the key schema is only needed to build keys, not to compare them
+  explicit GenericComparator(Schema * /*key_schema*/) {}
 };
 
 }  // namespace bustub
@@ -13,6 +13,7 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include "buffer/read_ahead.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -43,6 +44,10 @@ class IndexIterator {
   BufferPoolManager *bpm_;
   page_id_t cur_page_id_{INVALID_PAGE_ID};
   int index_{0};
+  // The entry last returned by operator*, copied out of the leaf since keys and values are stored apart.
+  MappingType current_;
+  // Prefetches the leaves ahead of the scan.
+  ReadAheadWindow read_ahead_;
 };
 
 }  // namespace bustub
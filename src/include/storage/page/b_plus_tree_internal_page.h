@@ -19,7 +19,8 @@ namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+// One slot past the max size holds the entry an overfull page keeps until it splits.
+#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)) - 1)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -28,9 +29,11 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
+ * Internal page format (keys are stored in increasing order, contiguously so
+ * that a search only touches keys; the page ids start after room for
+ * INTERNAL_PAGE_SIZE + 1 keys):
  *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(n) | ... | PAGE_ID(1) | ... | PAGE_ID(n) |
  *  --------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
@@ -110,7 +113,14 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   auto Borrow(BPlusTreeInternalPage *neighbor, bool is_left) -> KeyType;
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[0];
+  static constexpr size_t VALUES_OFFSET = (INTERNAL_PAGE_SIZE + 1) * sizeof(KeyType);
+
+  auto Keys() const -> const KeyType * { return reinterpret_cast<const KeyType *>(data_); }
+  auto Keys() -> KeyType * { return reinterpret_cast<KeyType *>(data_); }
+  auto Values() const -> const ValueType * { return reinterpret_cast<const ValueType *>(data_ + VALUES_OFFSET); }
+  auto Values() -> ValueType * { return reinterpret_cast<ValueType *>(data_ + VALUES_OFFSET); }
+
+  // Flexible array member for the key and value arrays.
+  char data_[0];
 };
 }  // namespace bustub
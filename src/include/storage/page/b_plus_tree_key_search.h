@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_search.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/**
+ * Whether the keys of a B+ tree page can be searched with KeyLowerBound: the key fits a 32 or 64 bit lane and is
+ * ordered by memcmp over its bytes.
+ */
+template <typename KeyType, typename KeyComparator>
+constexpr bool SIMD_KEY_SEARCH = (sizeof(KeyType) == 4 || sizeof(KeyType) == 8) &&
+                                 std::is_same_v<KeyComparator, GenericComparator<sizeof(KeyType)>>;
+
+/** Instruction sets KeyLowerBound can use, each one implying the ones before it. */
+enum class KeySearchIsa { SCALAR, SSE42, AVX2 };
+
+/** @return the best instruction set this CPU supports, detected once at startup */
+auto GetKeySearchIsa() -> KeySearchIsa;
+
+/**
+ * Lower bound over count sorted keys of width 4 or 8 bytes, stored contiguously in memcmp order.
+ * @param isa instruction set to use, which the CPU must support
+ * @return the index of the first key greater than or equal to key, or greater than key if upper is set
+ */
+auto KeyLowerBound(const char *keys, int count, size_t width, const char *key, bool upper,
+                   KeySearchIsa isa = GetKeySearchIsa()) -> int;
+
+}  // namespace bustub
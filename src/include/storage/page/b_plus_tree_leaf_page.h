@@ -26,9 +26,10 @@ namespace bustub {
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
- * Leaf page format (keys are stored in order):
+ * Leaf page format (keys are stored in order, contiguously so that a search
+ * only touches keys; the RIDs start after room for LEAF_PAGE_SIZE keys):
  *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(n) | ... | RID(1) | ... | RID(n)
  *  ----------------------------------------------------------------------
  *
  *  Header format (size in byte, 16 bytes in total):
@@ -58,7 +59,7 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
   auto ValueAt(int index) const -> ValueType;
-  auto KeyValueAt(int index) const -> const MappingType &;
+  auto KeyValueAt(int index) const -> MappingType;
   auto Binarysearch(const KeyType &key, KeyComparator comparator) const -> int;
   void Insert(KeyType key, ValueType value, int index);
   void Remove(int index);
@@ -91,8 +92,15 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   }
 
  private:
+  auto Keys() const -> const KeyType * { return reinterpret_cast<const KeyType *>(data_); }
+  auto Keys() -> KeyType * { return reinterpret_cast<KeyType *>(data_); }
+  auto Values() const -> const ValueType * {
+    return reinterpret_cast<const ValueType *>(data_ + LEAF_PAGE_SIZE * sizeof(KeyType));
+  }
+  auto Values() -> ValueType * { return reinterpret_cast<ValueType *>(data_ + LEAF_PAGE_SIZE * sizeof(KeyType)); }
+
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[0];
+  // Flexible array member for the key and value arrays.
+  char data_[0];
 };
 }  // namespace bustub
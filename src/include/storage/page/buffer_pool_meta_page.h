@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * The metadata page of a buffer pool instance, kept by DiskManager::WriteMetaPage() under the instance's index. It
+ * records what the instance needs to go on allocating pages after a restart: the next fresh page id and the head trunk
+ * of its free page list. It is written by FlushAllPages(), after the trunk pages themselves.
+ *
+ * Meta page format:
+ *  ------------------------------------------------------------------------------
+ * | Magic (4) | NumInstances (4) | NextPageId (4) | FreeListHeadPageId (4) |
+ *  ------------------------------------------------------------------------------
+ */
+class BufferPoolMetaPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BufferPoolMetaPage() = delete;
+  BufferPoolMetaPage(const BufferPoolMetaPage &other) = delete;
+
+  static constexpr uint32_t MAGIC = 0x42504d31;
+
+  uint32_t magic_;
+  uint32_t num_instances_;
+  page_id_t next_page_id_;
+  page_id_t free_list_head_page_id_;
+};
+
+static_assert(sizeof(BufferPoolMetaPage) <= BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
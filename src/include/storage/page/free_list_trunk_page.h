@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * A trunk page of the free page list. The free pages of a buffer pool form a chain of trunk pages, each of which
+ * lists up to CAPACITY other free pages. Trunk pages are free pages themselves, so the list takes no space of its own.
+ *
+ * Trunk page format:
+ *  ---------------------------------------------------------------------------
+ * | NextTrunkPageId (4) | Count (4) | FreePageId (4) | FreePageId (4) | ... |
+ *  ---------------------------------------------------------------------------
+ */
+class FreeListTrunkPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  FreeListTrunkPage() = delete;
+  FreeListTrunkPage(const FreeListTrunkPage &other) = delete;
+
+  static constexpr size_t CAPACITY = (BUSTUB_PAGE_SIZE - sizeof(page_id_t) - sizeof(uint32_t)) / sizeof(page_id_t);
+
+  page_id_t next_trunk_page_id_;
+  uint32_t count_;
+  page_id_t free_page_ids_[CAPACITY];
+};
+
+static_assert(sizeof(FreeListTrunkPage) <= BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
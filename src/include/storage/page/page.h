@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 
@@ -30,14 +33,11 @@ class Page {
   friend class BufferPoolManager;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() {
-    data_ = new char[BUSTUB_PAGE_SIZE];
-    ResetMemory();
-  }
+  /** Constructor. The buffer pool points the page at its frame, which it owns. */
+  Page() = default;
 
   /** Default destructor. */
-  ~Page() { delete[] data_; }
+  ~Page() = default;
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -51,18 +51,51 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. The version turns odd until the latch is released. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
 
+  /** Acquire the page read latch if that does not block. @return true if the latch was acquired */
+  inline auto TryRLatch() -> bool { return rwlatch_.TryRLock(); }
+
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * @return the version of the page when no writer holds its latch. If one does, waits for it by taking the read
+   * latch, so the version returned is always even.
+   */
+  inline auto StableVersion() -> uint64_t {
+    auto version = version_.load(std::memory_order_acquire);
+    if ((version & 1) != 0) {
+      RLatch();
+      version = version_.load(std::memory_order_relaxed);
+      RUnlatch();
+    }
+    return version;
+  }
+
+  /**
+   * @return true if the page has not been write latched since StableVersion() returned version, i.e. whatever was
+   * read from the page in between is consistent
+   */
+  inline auto ValidateVersion(uint64_t version) -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -81,18 +114,25 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow,
-  // we store it as a ptr.
-  char *data_;
-  /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  /** The actual data that is stored within a page: this page's frame in the buffer pool's FrameArena. */
+  char *data_{nullptr};
+  /** The ID of this page. Atomic because the buffer pool validates it on its lock-free fetch path. */
+  std::atomic<page_id_t> page_id_ = INVALID_PAGE_ID;
+  /**
+   * The pin count of this page. Lock-free fetches pin a frame by incrementing it while it is non-negative; the buffer
+   * pool sets it to -1 while it claims the frame for another page, which keeps those fetches out.
+   */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** True while the buffer pool reads this frame from, or writes it back to, disk without holding its latch. */
+  std::atomic<bool> io_in_progress_ = false;
+  /** Signalled when io_in_progress_ is cleared. Waiters must hold the buffer pool latch. */
+  std::condition_variable io_done_;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped when the write latch is taken and again when it is released, so optimistic readers can detect writers. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -81,6 +83,7 @@ class BasicPageGuard {
  private:
   friend class ReadPageGuard;
   friend class WritePageGuard;
+  friend class OptimisticPageGuard;
 
   BufferPoolManager *bpm_{nullptr};
   Page *page_{nullptr};
@@ -214,4 +217,56 @@ class WritePageGuard {
   BasicPageGuard guard_;
 };
 
+/**
+ * OptimisticPageGuard pins a page without latching it. Reads through it may observe a concurrent writer, so nothing
+ * read may be trusted (in particular, no page id may be followed) until Validate() says no writer latched the page in
+ * the meantime. On failure the caller starts over, or falls back to a ReadPageGuard.
+ */
+class OptimisticPageGuard {
+ public:
+  OptimisticPageGuard() = default;
+  OptimisticPageGuard(BufferPoolManager *bpm, Page *page, uint64_t version) : guard_(bpm, page), version_(version) {}
+  OptimisticPageGuard(const OptimisticPageGuard &) = delete;
+  auto operator=(const OptimisticPageGuard &) -> OptimisticPageGuard & = delete;
+  OptimisticPageGuard(OptimisticPageGuard &&that) noexcept = default;
+  auto operator=(OptimisticPageGuard &&that) noexcept -> OptimisticPageGuard & = default;
+  ~OptimisticPageGuard() = default;
+
+  /** @brief Unpin the page. */
+  void Drop() { guard_.Drop(); }
+
+  /**
+   * @return true if no writer has latched the page since the guard was created; false if the guard holds no page,
+   * because the buffer pool had no frame for it
+   */
+  auto Validate() -> bool { return guard_.page_ != nullptr && guard_.page_->ValidateVersion(version_); }
+
+  /**
+   * @brief Take the read latch on the page, moving the pin into a ReadPageGuard.
+   * @return the ReadPageGuard if the page is unchanged since the guard was created; otherwise nullopt, and this guard
+   * keeps its pin
+   */
+  auto TryUpgradeRead() -> std::optional<ReadPageGuard>;
+
+  /**
+   * @brief Take the write latch on the page, moving the pin into a WritePageGuard.
+   * @return the WritePageGuard if the page is unchanged since the guard was created; otherwise nullopt, and this guard
+   * keeps its pin
+   */
+  auto TryUpgradeWrite() -> std::optional<WritePageGuard>;
+
+  auto PageId() -> page_id_t { return guard_.PageId(); }
+
+  auto GetData() -> const char * { return guard_.GetData(); }
+
+  template <class T>
+  auto As() -> const T * {
+    return guard_.As<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+  uint64_t version_{0};
+};
+
 }  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <optional>
 #include <tuple>
@@ -28,6 +30,8 @@
 namespace bustub {
 
 static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
+/** Tuple offsets and sizes are 16 bits, so on 64 KiB pages the last byte of the page is left unused. */
+static constexpr uint64_t TABLE_PAGE_DATA_END = std::min<uint64_t>(BUSTUB_PAGE_SIZE, UINT16_MAX);
 
 /**
  * Slotted page format:
@@ -15,8 +15,10 @@
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/extent_allocator.h"
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
@@ -63,9 +65,19 @@ class TableHeap {
   /**
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
+   * @param access_type type of access to the page, AccessType::Scan when called from a table iterator
    * @return the meta and tuple
    */
-  auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
+  auto GetTuple(RID rid, AccessType access_type = AccessType::Unknown) -> std::pair<TupleMeta, Tuple>;
+
+  /**
+   * Read many tuples from the table. Their pages are fetched as one batch (see BufferPoolManager::FetchPagesRead()),
+   * so callers resolving many RIDs, e.g. from an index, should use this rather than GetTuple(). Keep the batches
+   * small compared to the buffer pool, since all of their pages are pinned at once.
+   * @param rids rids of the tuples to read, in any order
+   * @return the meta and tuple of each rid, in the order of rids
+   */
+  auto GetTuples(const std::vector<RID> &rids) -> std::vector<std::pair<TupleMeta, Tuple>>;
 
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
@@ -94,6 +106,8 @@ class TableHeap {
 
  private:
   BufferPoolManager *bpm_;
+  /** Creates the pages of this heap from extents of its own, so they are adjacent on disk. */
+  ExtentAllocator extents_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
   std::mutex latch_;
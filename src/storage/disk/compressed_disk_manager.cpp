@@ -0,0 +1,288 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager.cpp
+//
+// Identification: src/storage/disk/compressed_disk_manager.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/compressed_disk_manager.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/disk/page_codec.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr char MAP_MAGIC[8] = {'B', 'T', 'P', 'G', 'M', 'A', 'P', '1'};
+
+/** pwrite all of buf, retrying on EINTR and short writes. */
+auto WriteFully(int fd, const char *buf, size_t size, uint64_t offset) -> bool {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t rc = pwrite(fd, buf + done, size - done, static_cast<off_t>(offset + done));
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(rc);
+  }
+  return true;
+}
+
+/** pread all of buf, retrying on EINTR and short reads. */
+auto ReadFully(int fd, char *buf, size_t size, uint64_t offset) -> bool {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t rc = pread(fd, buf + done, size - done, static_cast<off_t>(offset + done));
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(rc);
+  }
+  return true;
+}
+
+auto SlotUnits(size_t size) -> size_t {
+  return (size + CompressedDiskManager::SLOT_UNIT - 1) / CompressedDiskManager::SLOT_UNIT;
+}
+
+}  // namespace
+
+CompressedDiskManager::CompressedDiskManager(const std::string &db_file)
+    : DiskManager(db_file), map_name_(db_file + ".map") {
+  map_fd_ = open(map_name_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (map_fd_ < 0) {
+    throw Exception("can't open page map file");
+  }
+  LoadMap();
+}
+
+CompressedDiskManager::~CompressedDiskManager() {
+  if (map_fd_ >= 0) {
+    Sync();
+    close(map_fd_);
+  }
+}
+
+void CompressedDiskManager::LoadMap() {
+  struct stat stat_buf;
+  if (fstat(map_fd_, &stat_buf) != 0) {
+    throw Exception("can't stat page map file");
+  }
+  auto map_size = static_cast<uint64_t>(stat_buf.st_size);
+  char header[MAP_HEADER_SIZE] = {};
+  if (map_size < MAP_HEADER_SIZE) {
+    // A new map: stamp it with the page size, which the slot layout depends on.
+    memcpy(header, MAP_MAGIC, sizeof(MAP_MAGIC));
+    auto page_size = static_cast<uint32_t>(BUSTUB_PAGE_SIZE);
+    memcpy(header + sizeof(MAP_MAGIC), &page_size, sizeof(page_size));
+    if (!WriteFully(map_fd_, header, MAP_HEADER_SIZE, 0)) {
+      throw Exception("can't write page map file");
+    }
+    return;
+  }
+  uint32_t page_size = 0;
+  if (!ReadFully(map_fd_, header, MAP_HEADER_SIZE, 0) || memcmp(header, MAP_MAGIC, sizeof(MAP_MAGIC)) != 0) {
+    throw Exception("page map file is corrupt");
+  }
+  memcpy(&page_size, header + sizeof(MAP_MAGIC), sizeof(page_size));
+  if (page_size != BUSTUB_PAGE_SIZE) {
+    throw Exception("page map file was written with a different page size");
+  }
+
+  map_.resize((map_size - MAP_HEADER_SIZE) / sizeof(MapEntry));
+  if (!map_.empty() &&
+      !ReadFully(map_fd_, reinterpret_cast<char *>(map_.data()), map_.size() * sizeof(MapEntry), MAP_HEADER_SIZE)) {
+    throw Exception("can't read page map file");
+  }
+
+  // Everything between the slots of live pages is free.
+  std::vector<std::pair<uint64_t, uint64_t>> slots;
+  for (const auto &entry : map_) {
+    if ((entry.flags_ & PRESENT) != 0) {
+      uint64_t length = SlotUnits(entry.size_) * SLOT_UNIT;
+      slots.emplace_back(entry.offset_, length);
+      stored_bytes_ += length;
+      stored_pages_++;
+    }
+  }
+  std::sort(slots.begin(), slots.end());
+  for (const auto &[offset, length] : slots) {
+    if (offset > file_end_) {
+      AddFreeSpace(file_end_, offset - file_end_);
+    }
+    file_end_ = std::max(file_end_, offset + length);
+  }
+}
+
+void CompressedDiskManager::AddFreeSpace(uint64_t offset, uint64_t length) {
+  while (length >= SLOT_UNIT) {
+    uint64_t units = std::min<uint64_t>(length / SLOT_UNIT, SLOT_CLASSES);
+    free_slots_[units - 1].push_back(offset);
+    offset += units * SLOT_UNIT;
+    length -= units * SLOT_UNIT;
+  }
+}
+
+auto CompressedDiskManager::AllocateSlot(size_t slot_class) -> uint64_t {
+  // Prefer an exact fit, then split the smallest larger slot, then grow the file.
+  for (size_t units = slot_class; units <= SLOT_CLASSES; units++) {
+    auto &free_list = free_slots_[units - 1];
+    if (free_list.empty()) {
+      continue;
+    }
+    uint64_t offset = free_list.back();
+    free_list.pop_back();
+    AddFreeSpace(offset + slot_class * SLOT_UNIT, (units - slot_class) * SLOT_UNIT);
+    return offset;
+  }
+  uint64_t offset = file_end_;
+  file_end_ += slot_class * SLOT_UNIT;
+  return offset;
+}
+
+void CompressedDiskManager::Sync() {
+  std::vector<std::pair<uint64_t, size_t>> released;
+  {
+    std::scoped_lock latch(map_latch_);
+    released.swap(pending_free_);
+  }
+  DiskManager::Sync();
+  if (fdatasync(map_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing the page map");
+    std::scoped_lock latch(map_latch_);
+    pending_free_.insert(pending_free_.end(), released.begin(), released.end());
+    return;
+  }
+  // The map entries that replaced these slots are durable now.
+  std::scoped_lock latch(map_latch_);
+  for (const auto &[offset, units] : released) {
+    free_slots_[units - 1].push_back(offset);
+  }
+}
+
+void CompressedDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  ScopedLatency latency(&write_latency_);
+  num_writes_ += 1;
+  // Only keep the compressed image if it saves at least one slot unit.
+  char slot[BUSTUB_PAGE_SIZE];
+  MapEntry entry{0, 0, PRESENT | COMPRESSED};
+  entry.size_ = static_cast<uint32_t>(PageCodec::Compress(page_data, slot, BUSTUB_PAGE_SIZE - SLOT_UNIT));
+  if (entry.size_ == 0) {
+    memcpy(slot, page_data, BUSTUB_PAGE_SIZE);
+    entry.size_ = BUSTUB_PAGE_SIZE;
+    entry.flags_ = PRESENT;
+  }
+  size_t units = SlotUnits(entry.size_);
+  memset(slot + entry.size_, 0, units * SLOT_UNIT - entry.size_);
+
+  {
+    std::scoped_lock latch(map_latch_);
+    entry.offset_ = AllocateSlot(units);
+  }
+  // All slots are in the db file; the page ids of this layout say nothing about where a page is stored.
+  SegmentFile *file = &segments_[0];
+  uint64_t end = entry.offset_ + units * SLOT_UNIT;
+  if (end > file->reserved_) {
+    ReserveSpace(file, end);
+  }
+  if (!WriteFully(file->fd_, slot, units * SLOT_UNIT, entry.offset_)) {
+    LOG_DEBUG("I/O error while writing");
+    std::scoped_lock latch(map_latch_);
+    free_slots_[units - 1].push_back(entry.offset_);
+    return;
+  }
+  uint64_t size = file->size_;
+  while (size < end && !file->size_.compare_exchange_weak(size, end)) {
+  }
+
+  std::scoped_lock latch(map_latch_);
+  auto index = static_cast<size_t>(page_id);
+  if (index >= map_.size()) {
+    map_.resize(index + 1, MapEntry{0, 0, 0});
+  }
+  MapEntry &old = map_[index];
+  if ((old.flags_ & PRESENT) != 0) {
+    pending_free_.emplace_back(old.offset_, SlotUnits(old.size_));
+    stored_bytes_ -= SlotUnits(old.size_) * SLOT_UNIT;
+    stored_pages_--;
+  }
+  old = entry;
+  stored_bytes_ += units * SLOT_UNIT;
+  stored_pages_++;
+  if (!WriteFully(map_fd_, reinterpret_cast<const char *>(&entry), sizeof(MapEntry),
+                  MAP_HEADER_SIZE + index * sizeof(MapEntry))) {
+    LOG_DEBUG("I/O error while writing the page map");
+  }
+}
+
+void CompressedDiskManager::WritePages(page_id_t page_id, const std::vector<const char *> &pages_data) {
+  for (size_t i = 0; i < pages_data.size(); i++) {
+    WritePage(page_id + static_cast<page_id_t>(i), pages_data[i]);
+  }
+}
+
+void CompressedDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  ScopedLatency latency(&read_latency_);
+  MapEntry entry{0, 0, 0};
+  {
+    std::scoped_lock latch(map_latch_);
+    if (page_id >= 0 && static_cast<size_t>(page_id) < map_.size()) {
+      entry = map_[page_id];
+    }
+  }
+  if ((entry.flags_ & PRESENT) == 0) {
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  if ((entry.flags_ & COMPRESSED) == 0) {
+    if (!ReadFully(segments_[0].fd_, page_data, BUSTUB_PAGE_SIZE, entry.offset_)) {
+      LOG_DEBUG("I/O error while reading");
+      memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    }
+    return;
+  }
+  char slot[BUSTUB_PAGE_SIZE];
+  if (!ReadFully(segments_[0].fd_, slot, entry.size_, entry.offset_) ||
+      !PageCodec::Decompress(slot, entry.size_, page_data)) {
+    LOG_DEBUG("I/O error while reading a compressed page");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+  }
+}
+
+void CompressedDiskManager::ReadPages(page_id_t page_id, const std::vector<char *> &pages_data) {
+  for (size_t i = 0; i < pages_data.size(); i++) {
+    ReadPage(page_id + static_cast<page_id_t>(i), pages_data[i]);
+  }
+}
+
+auto CompressedDiskManager::GetStoredBytes() const -> uint64_t {
+  std::scoped_lock latch(map_latch_);
+  return stored_bytes_;
+}
+
+auto CompressedDiskManager::GetNumStoredPages() const -> size_t {
+  std::scoped_lock latch(map_latch_);
+  return stored_pages_;
+}
+
+}  // namespace bustub
@@ -10,8 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
@@ -27,10 +34,11 @@ namespace bustub {
 static char *buffer_used;
 
 /**
- * Constructor: open/create a single database file & log file
+ * Constructor: open/create the database file (segment 0) & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io)
+    : file_name_(db_file), segments_(new SegmentFile[MAX_SEGMENT_FILES]) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -50,75 +58,388 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
   }
 
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
+  direct_io_ = direct_io;
+  if (OpenSegment(0, true) == nullptr) {
+    throw Exception("can't open db file");
+  }
+  // Metadata left over from an earlier database file of the same name does not describe this one.
+  int meta_flags = O_RDWR | O_CREAT | (segments_[0].size_ == 0 ? O_TRUNC : 0);
+  meta_fd_ = open((file_name_ + ".meta").c_str(), meta_flags, 0644);
+  if (meta_fd_ < 0) {
+    throw Exception("can't open db meta file");
   }
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  for (size_t i = 0; i < num_segments_; i++) {
+    if (segments_[i].fd_ >= 0) {
+      close(segments_[i].fd_);
+    }
+  }
+  if (meta_fd_ >= 0) {
+    close(meta_fd_);
+  }
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
   {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+    shut_down_ = true;
+    for (size_t i = 0; i < num_segments_; i++) {
+      if (segments_[i].fd_ >= 0) {
+        fdatasync(segments_[i].fd_);
+        close(segments_[i].fd_);
+        segments_[i].fd_ = -1;
+      }
+    }
+  }
+  {
+    std::scoped_lock meta_latch(meta_latch_);
+    if (meta_fd_ >= 0) {
+      fdatasync(meta_fd_);
+      close(meta_fd_);
+      meta_fd_ = -1;
+    }
   }
   log_io_.close();
 }
 
 /**
- * Write the contents of the specified page into disk file
+ * Flush every page written so far to stable storage
  */
-void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
+void DiskManager::Sync() {
+  ScopedLatency latency(&sync_latency_);
+  for (size_t i = 0; i < num_segments_; i++) {
+    int fd = segments_[i].fd_;
+    if (fd >= 0 && fdatasync(fd) != 0) {
+      LOG_DEBUG("I/O error while syncing");
+    }
+  }
+  int meta_fd = meta_fd_;
+  if (meta_fd >= 0 && fdatasync(meta_fd) != 0) {
+    LOG_DEBUG("I/O error while syncing the meta file");
+  }
+}
+
+/**
+ * Write a metadata page to the meta file, or keep it in memory if there is no database file
+ */
+void DiskManager::WriteMetaPage(uint32_t index, const char *page_data) {
+  std::scoped_lock meta_latch(meta_latch_);
+  if (file_name_.empty()) {
+    if (index >= meta_pages_.size()) {
+      meta_pages_.resize(index + 1);
+    }
+    if (meta_pages_[index] == nullptr) {
+      meta_pages_[index] = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+    }
+    memcpy(meta_pages_[index].get(), page_data, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  auto offset = static_cast<off_t>(static_cast<uint64_t>(index) * BUSTUB_PAGE_SIZE);
+  if (meta_fd_ < 0 || pwrite(meta_fd_, page_data, BUSTUB_PAGE_SIZE, offset) != BUSTUB_PAGE_SIZE) {
+    LOG_DEBUG("I/O error while writing the meta file");
+  }
+}
+
+/**
+ * Read a metadata page; a page that was never written reads as missing
+ */
+auto DiskManager::ReadMetaPage(uint32_t index, char *page_data) -> bool {
+  std::scoped_lock meta_latch(meta_latch_);
+  if (file_name_.empty()) {
+    if (index >= meta_pages_.size() || meta_pages_[index] == nullptr) {
+      return false;
+    }
+    memcpy(page_data, meta_pages_[index].get(), BUSTUB_PAGE_SIZE);
+    return true;
+  }
+  auto offset = static_cast<off_t>(static_cast<uint64_t>(index) * BUSTUB_PAGE_SIZE);
+  return meta_fd_ >= 0 && pread(meta_fd_, page_data, BUSTUB_PAGE_SIZE, offset) == BUSTUB_PAGE_SIZE;
+}
+
+/**
+ * Open (or create) a segment file; segment 0 is the db file and segment n is db_file.n
+ */
+auto DiskManager::OpenSegment(size_t segment, bool create) -> SegmentFile * {
+  SegmentFile *file = &segments_[segment];
+  if (file->fd_ >= 0 || shut_down_) {
+    return file->fd_ >= 0 ? file : nullptr;
+  }
+  std::string name = segment == 0 ? file_name_ : file_name_ + "." + std::to_string(segment);
+  int flags = O_RDWR | (create ? O_CREAT : 0);
+  int fd = -1;
+#ifdef O_DIRECT
+  if (direct_io_) {
+    fd = open(name.c_str(), flags | O_DIRECT, 0644);
+    // tmpfs and some other file systems reject O_DIRECT
+    if (fd < 0 && errno == EINVAL) {
+      LOG_DEBUG("O_DIRECT is not supported, falling back to buffered I/O");
+      direct_io_ = false;
+    }
+  }
+  // Segment files opened earlier keep their O_DIRECT, so each file's I/O goes by its own flag.
+  file->direct_ = fd >= 0;
+#endif
+  if (fd < 0) {
+    fd = open(name.c_str(), flags, 0644);
+    if (fd < 0) {
+      return nullptr;
+    }
+  }
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) == 0) {
+    file->size_ = static_cast<uint64_t>(stat_buf.st_size);
+    file->reserved_ = file->size_.load();
+  }
+  file->fd_ = fd;
+  if (segment >= num_segments_) {
+    num_segments_ = segment + 1;
+  }
+  return file;
+}
+
+auto DiskManager::GetSegment(page_id_t page_id, bool create) -> SegmentFile * {
+  if (segments_ == nullptr || page_id < 0) {
+    return nullptr;
+  }
+  SegmentFile *file = &segments_[page_id / SEGMENT_FILE_PAGES];
+  if (file->fd_ >= 0) {
+    return file;
+  }
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
+  return OpenSegment(page_id / SEGMENT_FILE_PAGES, create);
+}
+
+/**
+ * Runs `io` on page_data, or on an aligned copy of it when O_DIRECT needs one and page_data is not aligned
+ */
+template <typename IoFunc>
+static auto WithAlignedBuffer(bool direct_io, char *page_data, bool copy_in, bool copy_out, IoFunc io) -> ssize_t {
+  if (!direct_io || reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_SIZE == 0) {
+    return io(page_data);
+  }
+  auto *bounce = static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE));
+  if (copy_in) {
+    memcpy(bounce, page_data, BUSTUB_PAGE_SIZE);
+  }
+  ssize_t result = io(bounce);
+  if (copy_out && result > 0) {
+    memcpy(page_data, bounce, static_cast<size_t>(result));
+  }
+  std::free(bounce);
+  return result;
+}
+
+/**
+ * Grow the cached size of a segment file if a write extended it to `end` bytes
+ */
+static void GrowFileSize(std::atomic<uint64_t> *file_size, uint64_t end) {
+  uint64_t size = *file_size;
+  while (size < end && !file_size->compare_exchange_weak(size, end)) {
+  }
+}
+
+/**
+ * Write the contents of the specified page into its segment file
+ */
+void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  ScopedLatency latency(&write_latency_);
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
+  SegmentFile *file = GetSegment(page_id, true);
+  if (file == nullptr) {
+    LOG_DEBUG("I/O error while writing: can't open segment file");
+    return;
+  }
+  uint64_t offset = SegmentOffset(page_id);
+  if (offset + BUSTUB_PAGE_SIZE > file->reserved_) {
+    ReserveSpace(file, offset + BUSTUB_PAGE_SIZE, SEGMENT_FILE_BYTES);
+  }
+  int fd = file->fd_;
+  // O_DIRECT transfers whole pages, so partial writes only happen on errors like a full disk.
+  ssize_t written = WithAlignedBuffer(file->direct_, const_cast<char *>(page_data), true, false, [&](char *buf) {
+    ssize_t rc;
+    do {
+      rc = pwrite(fd, buf, BUSTUB_PAGE_SIZE, static_cast<off_t>(offset));
+    } while (rc < 0 && errno == EINTR);
+    return rc;
+  });
+  if (written != BUSTUB_PAGE_SIZE) {
     LOG_DEBUG("I/O error while writing");
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  GrowFileSize(&file->size_, offset + BUSTUB_PAGE_SIZE);
+}
+
+/**
+ * Write the contents of consecutive pages into their segment file, IOV_MAX pages per system call
+ */
+void DiskManager::WritePages(page_id_t page_id, const std::vector<const char *> &pages_data) {
+  if (pages_data.empty()) {
+    return;
+  }
+  // A run that crosses into the next segment file is written as two runs.
+  size_t in_segment = SEGMENT_FILE_PAGES - static_cast<size_t>(page_id % SEGMENT_FILE_PAGES);
+  if (pages_data.size() > in_segment) {
+    WritePages(page_id, {pages_data.begin(), pages_data.begin() + in_segment});
+    WritePages(page_id + static_cast<page_id_t>(in_segment), {pages_data.begin() + in_segment, pages_data.end()});
+    return;
+  }
+  bool aligned = std::all_of(pages_data.begin(), pages_data.end(), [](const char *page_data) {
+    return reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_SIZE == 0;
+  });
+  SegmentFile *file = GetSegment(page_id, true);
+  if (file == nullptr || (file->direct_ && !aligned)) {
+    for (size_t i = 0; i < pages_data.size(); i++) {
+      WritePage(page_id + static_cast<page_id_t>(i), pages_data[i]);
+    }
+    return;
+  }
+  ScopedLatency latency(&write_latency_);
+  uint64_t offset = SegmentOffset(page_id);
+  num_writes_ += static_cast<int>(pages_data.size());
+  if (offset + pages_data.size() * BUSTUB_PAGE_SIZE > file->reserved_) {
+    ReserveSpace(file, offset + pages_data.size() * BUSTUB_PAGE_SIZE, SEGMENT_FILE_BYTES);
+  }
+  int fd = file->fd_;
+  std::vector<iovec> iov(std::min<size_t>(pages_data.size(), IOV_MAX));
+  size_t written = 0;
+  while (written < pages_data.size()) {
+    size_t count = std::min(pages_data.size() - written, iov.size());
+    for (size_t i = 0; i < count; i++) {
+      iov[i].iov_base = const_cast<char *>(pages_data[written + i]);
+      iov[i].iov_len = BUSTUB_PAGE_SIZE;
+    }
+    ssize_t rc;
+    do {
+      rc = pwritev(fd, iov.data(), static_cast<int>(count), static_cast<off_t>(offset + written * BUSTUB_PAGE_SIZE));
+    } while (rc < 0 && errno == EINTR);
+    if (rc < BUSTUB_PAGE_SIZE) {
+      LOG_DEBUG("I/O error while writing");
+      break;
+    }
+    // A page that was only partly written is written again in full.
+    written += static_cast<size_t>(rc) / BUSTUB_PAGE_SIZE;
+  }
+  GrowFileSize(&file->size_, offset + written * BUSTUB_PAGE_SIZE);
+}
+
+/**
+ * Reserve disk space for a segment file in extents, without changing its size
+ */
+void DiskManager::ReserveSpace(SegmentFile *segment, uint64_t end, uint64_t limit) {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  uint64_t reserved = segment->reserved_;
+  if (end <= reserved) {
+    return;
+  }
+  uint64_t extent = std::max<uint64_t>(static_cast<uint64_t>(DISK_EXTENT_PAGES) * BUSTUB_PAGE_SIZE, reserved / 8);
+  extent = (extent + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE * BUSTUB_PAGE_SIZE;
+  // A write far past the end leaves a hole; don't reserve space for the hole.
+  uint64_t start = std::max(reserved, end - std::min<uint64_t>(end, BUSTUB_PAGE_SIZE));
+  // A page-addressed segment file never grows past SEGMENT_FILE_PAGES pages; start < end <= new_reserved.
+  uint64_t new_reserved = std::max(std::min(start + extent, limit), end);
+#ifdef FALLOC_FL_KEEP_SIZE
+  // Only a hint for the file system's allocator; if it is not supported, the file grows page by page as before.
+  auto length = static_cast<off_t>(new_reserved - start);
+  if (fallocate(segment->fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(start), length) != 0) {
+    LOG_DEBUG("cannot preallocate space for the db file");
+  }
+#endif
+  segment->reserved_ = new_reserved;
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
+  ScopedLatency latency(&read_latency_);
+  SegmentFile *file = GetSegment(page_id, false);
+  uint64_t offset = SegmentOffset(page_id);
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (file == nullptr || offset >= file->size_) {
     LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  int fd = file->fd_;
+  ssize_t read_count = WithAlignedBuffer(file->direct_, page_data, false, true, [&](char *buf) {
+    ssize_t total = 0;
+    while (total < BUSTUB_PAGE_SIZE) {
+      ssize_t rc = pread(fd, buf + total, BUSTUB_PAGE_SIZE - total, static_cast<off_t>(offset + total));
+      if (rc < 0 && errno == EINTR) {
+        continue;
+      }
+      if (rc <= 0) {
+        break;
+      }
+      total += rc;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+    return total;
+  });
+  // if file ends before reading BUSTUB_PAGE_SIZE
+  if (read_count < BUSTUB_PAGE_SIZE) {
+    LOG_DEBUG("Read less than a page");
+    memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+  }
+}
+
+/**
+ * Read the contents of consecutive pages into the given memory areas, IOV_MAX pages per system call
+ */
+void DiskManager::ReadPages(page_id_t page_id, const std::vector<char *> &pages_data) {
+  if (pages_data.empty()) {
+    return;
+  }
+  // A run that crosses into the next segment file is read as two runs.
+  size_t in_segment = SEGMENT_FILE_PAGES - static_cast<size_t>(page_id % SEGMENT_FILE_PAGES);
+  if (pages_data.size() > in_segment) {
+    ReadPages(page_id, {pages_data.begin(), pages_data.begin() + in_segment});
+    ReadPages(page_id + static_cast<page_id_t>(in_segment), {pages_data.begin() + in_segment, pages_data.end()});
+    return;
+  }
+  bool aligned = std::all_of(pages_data.begin(), pages_data.end(), [](const char *page_data) {
+    return reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_SIZE == 0;
+  });
+  SegmentFile *file = GetSegment(page_id, false);
+  if (file == nullptr || (file->direct_ && !aligned)) {
+    for (size_t i = 0; i < pages_data.size(); i++) {
+      ReadPage(page_id + static_cast<page_id_t>(i), pages_data[i]);
+    }
+    return;
+  }
+  ScopedLatency latency(&read_latency_);
+  uint64_t offset = SegmentOffset(page_id);
+  int fd = file->fd_;
+  std::vector<iovec> iov(std::min<size_t>(pages_data.size(), IOV_MAX));
+  size_t read_bytes = 0;
+  size_t total_bytes = pages_data.size() * BUSTUB_PAGE_SIZE;
+  while (read_bytes < total_bytes) {
+    // Resume in the middle of a page after a short read.
+    size_t first = read_bytes / BUSTUB_PAGE_SIZE;
+    size_t count = std::min(pages_data.size() - first, iov.size());
+    for (size_t i = 0; i < count; i++) {
+      size_t skip = i == 0 ? read_bytes % BUSTUB_PAGE_SIZE : 0;
+      iov[i].iov_base = pages_data[first + i] + skip;
+      iov[i].iov_len = BUSTUB_PAGE_SIZE - skip;
+    }
+    ssize_t rc;
+    do {
+      rc = preadv(fd, iov.data(), static_cast<int>(count), static_cast<off_t>(offset + read_bytes));
+    } while (rc < 0 && errno == EINTR);
+    if (rc <= 0) {
+      break;
     }
+    read_bytes += static_cast<size_t>(rc);
+  }
+  // The file ends (or an error stopped us) before the last page: the rest reads as zeros.
+  for (size_t i = read_bytes / BUSTUB_PAGE_SIZE; i < pages_data.size(); i++) {
+    size_t skip = i == read_bytes / BUSTUB_PAGE_SIZE ? read_bytes % BUSTUB_PAGE_SIZE : 0;
+    memset(pages_data[i] + skip, 0, BUSTUB_PAGE_SIZE - skip);
   }
 }
 
@@ -199,13 +520,26 @@ auto DiskManager::GetNumWrites() const -> int { return num_writes_; }
  */
 auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 
+/**
+ * Returns the I/O latency histograms
+ */
+auto DiskManager::GetMetrics() const -> DiskMetricsSnapshot {
+  return {read_latency_.Snapshot(), write_latency_.Snapshot(), sync_latency_.Snapshot()};
+}
+
+auto DiskMetricsSnapshot::ToRows() const -> std::vector<std::pair<std::string, std::string>> {
+  return {{"read_latency", read_latency_.ToString()},
+          {"write_latency", write_latency_.ToString()},
+          {"sync_latency", sync_latency_.ToString()}};
+}
+
 /**
  * Private helper function to get disk file size
  */
-auto DiskManager::GetFileSize(const std::string &file_name) -> int {
+auto DiskManager::GetFileSize(const std::string &file_name) -> int64_t {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
 }
 
 }  // namespace bustub
@@ -12,15 +12,18 @@
 
 #include "storage/disk/disk_manager_memory.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
 #include <iostream>
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 
 namespace bustub {
 
@@ -33,6 +36,7 @@ DiskManagerMemory::DiskManagerMemory(size_t pages) { memory_ = new char[pages *
  * Write the contents of the specified page into disk file
  */
 void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
+  ScopedLatency latency(&write_latency_);
   size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
   // set write cursor to offset
   num_writes_ += 1;
@@ -43,8 +47,146 @@ void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
  * Read the contents of the specified page into the given memory area
  */
 void DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) {
+  ScopedLatency latency(&read_latency_);
   int64_t offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
   memcpy(page_data, memory_ + offset, BUSTUB_PAGE_SIZE);
 }
 
+DiskManagerUnlimitedMemory::DiskManagerUnlimitedMemory() : chunks_(new std::atomic<Chunk *>[MAX_CHUNKS]()) {}
+
+DiskManagerUnlimitedMemory::~DiskManagerUnlimitedMemory() {
+  for (size_t i = 0; i < MAX_CHUNKS; i++) {
+    Chunk *chunk = chunks_[i].load();
+    if (chunk == nullptr) {
+      continue;
+    }
+    for (auto &page : *chunk) {
+      delete page.load();
+    }
+    delete chunk;
+  }
+}
+
+void DiskManagerUnlimitedMemory::WritePage(page_id_t page_id, const char *page_data) {
+  ScopedLatency latency(&write_latency_);
+  Delay(1);
+  num_writes_ += 1;
+  CopyIn(page_id, page_data);
+}
+
+void DiskManagerUnlimitedMemory::WritePages(page_id_t page_id, const std::vector<const char *> &pages_data) {
+  ScopedLatency latency(&write_latency_);
+  Delay(pages_data.size());
+  num_writes_ += static_cast<int>(pages_data.size());
+  for (size_t i = 0; i < pages_data.size(); i++) {
+    CopyIn(page_id + static_cast<page_id_t>(i), pages_data[i]);
+  }
+}
+
+void DiskManagerUnlimitedMemory::ReadPage(page_id_t page_id, char *page_data) {
+  ScopedLatency latency(&read_latency_);
+  Delay(1);
+  CopyOut(page_id, page_data);
+}
+
+void DiskManagerUnlimitedMemory::ReadPages(page_id_t page_id, const std::vector<char *> &pages_data) {
+  ScopedLatency latency(&read_latency_);
+  Delay(pages_data.size());
+  for (size_t i = 0; i < pages_data.size(); i++) {
+    CopyOut(page_id + static_cast<page_id_t>(i), pages_data[i]);
+  }
+}
+
+void DiskManagerUnlimitedMemory::SetLatency(size_t latency_ms) {
+  DiskLatencyModel model;
+  model.latency_ = std::chrono::milliseconds(latency_ms);
+  SetLatencyModel(model);
+}
+
+void DiskManagerUnlimitedMemory::SetLatencyModel(const DiskLatencyModel &model) {
+  {
+    std::scoped_lock<std::mutex> lock(model_latch_);
+    model_ = model;
+    delay_ = model.latency_.count() > 0 || model.queue_depth_ > 0 || model.bandwidth_ > 0;
+  }
+  model_cv_.notify_all();
+}
+
+auto DiskManagerUnlimitedMemory::GetPage(page_id_t page_id, bool create) -> ProtectedPage * {
+  BUSTUB_ASSERT(page_id >= 0, "invalid page id");
+  auto &chunk_slot = chunks_[static_cast<size_t>(page_id) / PAGES_PER_CHUNK];
+  Chunk *chunk = chunk_slot.load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    if (!create) {
+      return nullptr;
+    }
+    // Whoever installs the chunk first wins; the others free theirs.
+    auto *new_chunk = new Chunk();
+    if (chunk_slot.compare_exchange_strong(chunk, new_chunk, std::memory_order_acq_rel)) {
+      chunk = new_chunk;
+    } else {
+      delete new_chunk;
+    }
+  }
+  auto &page_slot = (*chunk)[static_cast<size_t>(page_id) % PAGES_PER_CHUNK];
+  ProtectedPage *page = page_slot.load(std::memory_order_acquire);
+  if (page == nullptr && create) {
+    auto *new_page = new ProtectedPage();
+    if (page_slot.compare_exchange_strong(page, new_page, std::memory_order_acq_rel)) {
+      page = new_page;
+    } else {
+      delete new_page;
+    }
+  }
+  return page;
+}
+
+void DiskManagerUnlimitedMemory::CopyIn(page_id_t page_id, const char *page_data) {
+  ProtectedPage *page = GetPage(page_id, true);
+  std::unique_lock<std::shared_mutex> lock(page->latch_);
+  memcpy(page->data_.data(), page_data, BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerUnlimitedMemory::CopyOut(page_id_t page_id, char *page_data) {
+  ProtectedPage *page = page_id < 0 ? nullptr : GetPage(page_id, false);
+  if (page == nullptr) {
+    LOG_WARN("page not exist");
+    return;
+  }
+  std::shared_lock<std::shared_mutex> lock(page->latch_);
+  memcpy(page_data, page->data_.data(), BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerUnlimitedMemory::Delay(size_t num_pages) {
+  if (!delay_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(model_latch_);
+  model_cv_.wait(lock, [&] { return model_.queue_depth_ == 0 || in_flight_ < model_.queue_depth_; });
+  in_flight_++;
+  // The request waits for its latency, and its transfer queues behind the transfers of the requests before it.
+  auto now = std::chrono::steady_clock::now();
+  auto done = now + model_.latency_;
+  if (model_.bandwidth_ > 0) {
+    auto transfer = std::chrono::nanoseconds(num_pages * BUSTUB_PAGE_SIZE * 1000000000ULL / model_.bandwidth_);
+    channel_free_ = std::max(now, channel_free_) + transfer;
+    done = std::max(done, channel_free_);
+  }
+  lock.unlock();
+
+  // Sleeping is only accurate to tens of microseconds, so the last stretch is spent yielding.
+  constexpr auto spin = std::chrono::microseconds(50);
+  if (done - std::chrono::steady_clock::now() > spin) {
+    std::this_thread::sleep_until(done - spin);
+  }
+  while (std::chrono::steady_clock::now() < done) {
+    std::this_thread::yield();
+  }
+
+  lock.lock();
+  in_flight_--;
+  lock.unlock();
+  model_cv_.notify_one();
+}
+
 }  // namespace bustub
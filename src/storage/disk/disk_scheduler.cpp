@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_workers > 0, "a disk scheduler needs at least one worker");
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back([this] { StartWorkerThread(); });
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  // Put a `std::nullopt` in the queue for every worker to signal them to exit once the queue is drained.
+  for (size_t i = 0; i < workers_.size(); i++) {
+    request_queue_.Put(std::nullopt);
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest r) { request_queue_.Put(std::make_optional(std::move(r))); }
+
+void DiskScheduler::StartWorkerThread() {
+  while (auto request = request_queue_.Get()) {
+    if (request->is_write_ && !request->pages_data_.empty()) {
+      disk_manager_->WritePages(request->page_id_, request->pages_data_);
+    } else if (request->is_write_) {
+      disk_manager_->WritePage(request->page_id_, request->data_);
+    } else if (!request->read_pages_data_.empty()) {
+      disk_manager_->ReadPages(request->page_id_, request->read_pages_data_);
+    } else {
+      disk_manager_->ReadPage(request->page_id_, request->data_);
+    }
+    if (request->on_complete_) {
+      request->on_complete_();
+    }
+    request->callback_.set_value(true);
+  }
+}
+
+}  // namespace bustub
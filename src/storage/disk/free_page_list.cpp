@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_list.cpp
+//
+// Identification: src/storage/disk/free_page_list.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_page_list.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bustub {
+
+FreePageList::FreePageList(DiskManager *disk_manager)
+    : disk_manager_(disk_manager), head_(std::make_unique<char[]>(BUSTUB_PAGE_SIZE)) {}
+
+auto FreePageList::Open(page_id_t head_page_id, page_id_t end_page_id) -> bool {
+  BUSTUB_ASSERT(head_page_id_ == INVALID_PAGE_ID && size_ == 0, "only an empty list can be reopened");
+  auto data = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  auto *trunk = reinterpret_cast<FreeListTrunkPage *>(data.get());
+  auto valid = [&](page_id_t page_id) { return page_id >= 0 && page_id < end_page_id && !Contains(page_id); };
+  bool damaged = false;
+  for (page_id_t page_id = head_page_id; page_id != INVALID_PAGE_ID && !damaged; page_id = trunk->next_trunk_page_id_) {
+    if (!valid(page_id)) {
+      damaged = true;
+      break;
+    }
+    disk_manager_->ReadPage(page_id, data.get());
+    if (trunk->count_ > FreeListTrunkPage::CAPACITY) {
+      damaged = true;
+      break;
+    }
+    if (page_id == head_page_id) {
+      memcpy(head_.get(), data.get(), BUSTUB_PAGE_SIZE);
+    }
+    SetListed(page_id);
+    size_++;
+    for (uint32_t i = 0; i < trunk->count_ && !damaged; i++) {
+      damaged = !valid(trunk->free_page_ids_[i]);
+      if (!damaged) {
+        SetListed(trunk->free_page_ids_[i]);
+        size_++;
+      }
+    }
+  }
+  if (damaged) {
+    listed_.clear();
+    size_ = 0;
+    return false;
+  }
+  head_page_id_ = head_page_id;
+  return true;
+}
+
+auto FreePageList::Pop(page_id_t *page_id) -> bool {
+  if (head_page_id_ == INVALID_PAGE_ID || !head_loaded_) {
+    return false;
+  }
+  auto *head = Head();
+  size_--;
+  if (head->count_ > 0) {
+    *page_id = head->free_page_ids_[--head->count_];
+    listed_[*page_id] = false;
+    head_dirty_ = true;
+    return true;
+  }
+  // The head trunk lists no other pages, so hand out the trunk itself and continue with the next one.
+  *page_id = head_page_id_;
+  listed_[*page_id] = false;
+  head_page_id_ = head->next_trunk_page_id_;
+  head_dirty_ = false;
+  if (auto it = unwritten_.find(head_page_id_); it != unwritten_.end()) {
+    head_ = std::move(it->second);
+    head_dirty_ = true;
+    unwritten_.erase(it);
+  } else if (head_page_id_ != INVALID_PAGE_ID) {
+    head_loaded_ = false;
+    head_read_started_ = false;
+  }
+  return true;
+}
+
+auto FreePageList::Push(page_id_t page_id) -> bool {
+  BUSTUB_ASSERT(page_id >= 0, "cannot free an invalid page");
+  if (Contains(page_id)) {
+    return false;
+  }
+  SetListed(page_id);
+  size_++;
+  auto *head = Head();
+  if (head_page_id_ != INVALID_PAGE_ID && head_loaded_ && head->count_ < FreeListTrunkPage::CAPACITY) {
+    head->free_page_ids_[head->count_++] = page_id;
+    head_dirty_ = true;
+    return true;
+  }
+  // The head trunk is full (or there is none, or it is still on disk): the freed page becomes the new head trunk.
+  if (head_loaded_ && head_dirty_ && head_page_id_ != INVALID_PAGE_ID) {
+    unwritten_.emplace(head_page_id_, std::move(head_));
+    head_ = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+    head = Head();
+  }
+  memset(head_.get(), 0, BUSTUB_PAGE_SIZE);
+  head->next_trunk_page_id_ = head_page_id_;
+  head->count_ = 0;
+  head_page_id_ = page_id;
+  head_loaded_ = true;
+  head_dirty_ = true;
+  return true;
+}
+
+auto FreePageList::StartHeadRead() -> page_id_t {
+  if (head_loaded_ || head_read_started_) {
+    return INVALID_PAGE_ID;
+  }
+  head_read_started_ = true;
+  return head_page_id_;
+}
+
+void FreePageList::LoadHead(page_id_t page_id, const char *data) {
+  if (page_id != head_page_id_ || head_loaded_) {
+    return;
+  }
+  memcpy(head_.get(), data, BUSTUB_PAGE_SIZE);
+  head_loaded_ = true;
+  head_dirty_ = false;
+}
+
+void FreePageList::Flush() {
+  if (head_dirty_ && head_loaded_ && head_page_id_ != INVALID_PAGE_ID) {
+    disk_manager_->WritePage(head_page_id_, head_.get());
+  }
+  head_dirty_ = false;
+  for (auto &[page_id, data] : unwritten_) {
+    disk_manager_->WritePage(page_id, data.get());
+  }
+  unwritten_.clear();
+}
+
+void FreePageList::SetListed(page_id_t page_id) {
+  if (static_cast<size_t>(page_id) >= listed_.size()) {
+    listed_.resize(std::max(listed_.size() * 2, static_cast<size_t>(page_id) + 1));
+  }
+  listed_[page_id] = true;
+}
+
+}  // namespace bustub
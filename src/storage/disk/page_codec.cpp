@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_codec.cpp
+//
+// Identification: src/storage/disk/page_codec.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_codec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t HASH_BITS = 12;
+constexpr size_t MAX_OFFSET = 65535;
+
+auto Load32(const char *p) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+auto Hash(uint32_t sequence) -> size_t { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Appends bytes to the output buffer until it is full. */
+class Writer {
+ public:
+  Writer(char *out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+  auto Put(uint8_t byte) -> bool {
+    if (size_ >= capacity_) {
+      return false;
+    }
+    out_[size_++] = static_cast<char>(byte);
+    return true;
+  }
+
+  auto Put(const char *data, size_t n) -> bool {
+    if (n > capacity_ - size_) {
+      return false;
+    }
+    memcpy(out_ + size_, data, n);
+    size_ += n;
+    return true;
+  }
+
+  /** Write the continuation bytes of a length whose nibble was 15. */
+  auto PutLength(size_t length) -> bool {
+    if (length < 15) {
+      return true;
+    }
+    for (length -= 15; length >= 255; length -= 255) {
+      if (!Put(255)) {
+        return false;
+      }
+    }
+    return Put(static_cast<uint8_t>(length));
+  }
+
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  char *out_;
+  size_t capacity_;
+  size_t size_{0};
+};
+
+/** Write the literals [literals, literals + literal_len), then a match unless match_len is 0. */
+auto PutSequence(Writer *writer, const char *literals, size_t literal_len, size_t offset, size_t match_len) -> bool {
+  size_t match_code = match_len == 0 ? 0 : match_len - PageCodec::MIN_MATCH;
+  auto token = static_cast<uint8_t>((std::min<size_t>(literal_len, 15) << 4) | std::min<size_t>(match_code, 15));
+  if (!writer->Put(token) || !writer->PutLength(literal_len) || !writer->Put(literals, literal_len)) {
+    return false;
+  }
+  if (match_len == 0) {
+    return true;
+  }
+  return writer->Put(static_cast<uint8_t>(offset & 0xff)) && writer->Put(static_cast<uint8_t>(offset >> 8)) &&
+         writer->PutLength(match_code);
+}
+
+/** Read a length whose nibble was 15 from its continuation bytes. */
+auto GetLength(const uint8_t *in, size_t size, size_t *pos, size_t *length) -> bool {
+  if (*length < 15) {
+    return true;
+  }
+  while (true) {
+    if (*pos >= size) {
+      return false;
+    }
+    uint8_t byte = in[(*pos)++];
+    *length += byte;
+    if (byte < 255) {
+      return true;
+    }
+  }
+}
+
+}  // namespace
+
+auto PageCodec::Compress(const char *page, char *out, size_t capacity) -> size_t {
+  // Positions plus one of the last 4-byte sequence with each hash, 0 for none.
+  std::array<uint32_t, 1 << HASH_BITS> table{};
+  Writer writer(out, capacity);
+  size_t pos = 0;
+  size_t anchor = 0;
+  while (pos + MIN_MATCH <= BUSTUB_PAGE_SIZE) {
+    const uint32_t sequence = Load32(page + pos);
+    const size_t hash = Hash(sequence);
+    const size_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(pos + 1);
+    if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || Load32(page + candidate - 1) != sequence) {
+      pos++;
+      continue;
+    }
+    const size_t match = candidate - 1;
+    size_t match_len = MIN_MATCH;
+    while (pos + match_len < BUSTUB_PAGE_SIZE && page[match + match_len] == page[pos + match_len]) {
+      match_len++;
+    }
+    if (!PutSequence(&writer, page + anchor, pos - anchor, pos - match, match_len)) {
+      return 0;
+    }
+    pos += match_len;
+    anchor = pos;
+  }
+  if (anchor < BUSTUB_PAGE_SIZE && !PutSequence(&writer, page + anchor, BUSTUB_PAGE_SIZE - anchor, 0, 0)) {
+    return 0;
+  }
+  return writer.Size();
+}
+
+auto PageCodec::Decompress(const char *in, size_t size, char *page) -> bool {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(in);
+  size_t pos = 0;
+  size_t out = 0;
+  while (pos < size) {
+    const uint8_t token = bytes[pos++];
+    size_t literal_len = token >> 4;
+    if (!GetLength(bytes, size, &pos, &literal_len) || literal_len > size - pos ||
+        literal_len > BUSTUB_PAGE_SIZE - out) {
+      return false;
+    }
+    memcpy(page + out, in + pos, literal_len);
+    pos += literal_len;
+    out += literal_len;
+    if (pos == size) {
+      break;
+    }
+
+    if (size - pos < 2) {
+      return false;
+    }
+    const size_t offset = bytes[pos] | (static_cast<size_t>(bytes[pos + 1]) << 8);
+    pos += 2;
+    size_t match_len = token & 0x0f;
+    if (!GetLength(bytes, size, &pos, &match_len)) {
+      return false;
+    }
+    match_len += MIN_MATCH;
+    if (offset == 0 || offset > out || match_len > BUSTUB_PAGE_SIZE - out) {
+      return false;
+    }
+    // The match may overlap the bytes it produces, so copy byte by byte.
+    for (size_t i = 0; i < match_len; i++, out++) {
+      page[out] = page[out - offset];
+    }
+  }
+  return out == BUSTUB_PAGE_SIZE;
+}
+
+}  // namespace bustub
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "common/config.h"
@@ -18,10 +20,13 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
                           const KeyComparator &comparator, int leaf_max_size, int internal_max_size)
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
+      extents_(buffer_pool_manager),
       comparator_(std::move(comparator)),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size),
-      header_page_id_(header_page_id) {
+      header_page_id_(header_page_id),
+      max_optimistic_descents_(
+          std::max<size_t>(1, buffer_pool_manager->GetPoolSize() / FRAMES_PER_OPTIMISTIC_DESCENT)) {
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
   auto header_page = guard.AsMut<BPlusTreeHeaderPage>();
   header_page->root_page_id_ = INVALID_PAGE_ID;
@@ -43,31 +48,173 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return GetRootPageId() == INVALID
 
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
+  std::optional<ReadPageGuard> leaf_guard = FindLeafRead(key);
+  if (!leaf_guard.has_value()) {
+    return false;
+  }
+  auto leaf = leaf_guard->As<LeafPage>();
+  int idx = leaf->Binarysearch(key, comparator_);
+  if (idx < leaf->GetSize() && !comparator_(key, leaf->KeyAt(idx))) {
+    if (result != nullptr) {
+      result->emplace_back(leaf->ValueAt(idx));
+    }
+    return true;
+  }
+  return false;
+}
+
+/*
+ * Descend to the leaf that may hold key. The header and inner pages are read
+ * optimistically a few times before falling back to latch crabbing, so
+ * readers do not fight over the shared latches of the pages near the root.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const KeyType &key) -> std::optional<ReadPageGuard> {
+  std::optional<ReadPageGuard> leaf;
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+    if (TryFindLeafOptimistic(key, &leaf)) {
+      return leaf;
+    }
+  }
   Context ctx;
-  ctx.read_set_.emplace_back(bpm_->FetchPageRead(header_page_id_));
+  ctx.read_set_.emplace_back(FetchPageReadWait(header_page_id_));
   ctx.root_page_id_ = ctx.read_set_.back().As<BPlusTreeHeaderPage>()->root_page_id_;
   if (ctx.root_page_id_ == INVALID_PAGE_ID) {
-    return false;
+    return std::nullopt;
   }
-  ctx.read_set_.emplace_back(bpm_->FetchPageRead(ctx.root_page_id_));
+  ctx.read_set_.emplace_back(FetchPageReadWait(ctx.root_page_id_));
   ctx.read_set_.pop_front();
   auto cur_page = ctx.read_set_.back().As<BPlusTreePage>();
   while (!cur_page->IsLeafPage()) {
     auto internal_page = reinterpret_cast<const InternalPage *>(cur_page);
     int idx = internal_page->Binarysearch(key, comparator_);
-    ctx.read_set_.emplace_back(bpm_->FetchPageRead(internal_page->ValueAt(idx)));
+    ctx.read_set_.emplace_back(FetchPageReadWait(internal_page->ValueAt(idx)));
     ctx.read_set_.pop_front();
     cur_page = ctx.read_set_.back().As<BPlusTreePage>();
   }
-  auto leaf = reinterpret_cast<const LeafPage *>(cur_page);
-  int idx = leaf->Binarysearch(key, comparator_);
-  if (idx < leaf->GetSize() && !comparator_(key, leaf->KeyAt(idx))) {
-    if (result != nullptr) {
-      result->emplace_back(leaf->ValueAt(idx));
+  return std::move(ctx.read_set_.back());
+}
+
+/*
+ * A descent pins up to two frames and gives up rather than wait for one, so
+ * with many threads descending at once the latch-crabbing passes, which cannot
+ * give up halfway, could find every frame pinned. Only a few run at once.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryDescendOptimistic(const KeyType &key, std::optional<OptimisticPageGuard> *leaf) -> bool {
+  if (optimistic_descents_.fetch_add(1) >= max_optimistic_descents_) {
+    optimistic_descents_ -= 1;
+    return false;
+  }
+  bool descended = DescendOptimistic(key, leaf);
+  optimistic_descents_ -= 1;
+  return descended;
+}
+
+/*
+ * A child's page id is only followed once its parent has been validated, and
+ * the parent is validated again once the child is pinned, so a child that was
+ * split or replaced in between is never searched. Nothing is latched.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::DescendOptimistic(const KeyType &key, std::optional<OptimisticPageGuard> *leaf) -> bool {
+  auto parent = bpm_->FetchPageOptimistic(header_page_id_);
+  if (!parent.Validate()) {
+    return false;
+  }
+  page_id_t child_pid = parent.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (!parent.Validate()) {
+    return false;
+  }
+  if (child_pid == INVALID_PAGE_ID) {
+    *leaf = std::nullopt;
+    return true;
+  }
+  while (true) {
+    auto child = bpm_->FetchPageOptimistic(child_pid);
+    if (!parent.Validate() || !child.Validate()) {
+      return false;
+    }
+    parent.Drop();
+    auto cur_page = child.As<BPlusTreePage>();
+    if (cur_page->IsLeafPage()) {
+      leaf->emplace(std::move(child));
+      return true;
     }
+    auto internal_page = reinterpret_cast<const InternalPage *>(cur_page);
+    child_pid = internal_page->ValueAt(internal_page->Binarysearch(key, comparator_));
+    if (!child.Validate()) {
+      return false;
+    }
+    parent = std::move(child);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryFindLeafOptimistic(const KeyType &key, std::optional<ReadPageGuard> *leaf) -> bool {
+  std::optional<OptimisticPageGuard> guard;
+  if (!TryDescendOptimistic(key, &guard)) {
+    return false;
+  }
+  if (!guard.has_value()) {
+    *leaf = std::nullopt;
     return true;
   }
-  return false;
+  *leaf = guard->TryUpgradeRead();
+  return leaf->has_value();
+}
+
+/*
+ * The leaf is only latched once it is reached, and it is used only if it did
+ * not change since its parent pointed to it, so its key range is still the one
+ * the descent relied on.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryFindLeafOptimisticWrite(const KeyType &key, std::optional<WritePageGuard> *leaf) -> bool {
+  std::optional<OptimisticPageGuard> guard;
+  if (!TryDescendOptimistic(key, &guard)) {
+    return false;
+  }
+  if (!guard.has_value()) {
+    *leaf = std::nullopt;
+    return true;
+  }
+  *leaf = guard->TryUpgradeWrite();
+  return leaf->has_value();
+}
+
+/*
+ * The frames are only short while other threads' descents hold them, and
+ * those let go soon, so a latch-crabbing pass waits rather than fail halfway.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchPageReadWait(page_id_t page_id) -> ReadPageGuard {
+  Page *page;
+  while ((page = bpm_->FetchPage(page_id)) == nullptr) {
+    std::this_thread::yield();
+  }
+  page->RLatch();
+  return {bpm_, page};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchPageWriteWait(page_id_t page_id) -> WritePageGuard {
+  Page *page;
+  while ((page = bpm_->FetchPage(page_id)) == nullptr) {
+    std::this_thread::yield();
+  }
+  page->WLatch();
+  return {bpm_, page};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewPageWriteWait(page_id_t *page_id) -> WritePageGuard {
+  Page *page;
+  while ((page = extents_.NewPage(page_id)) == nullptr) {
+    std::this_thread::yield();
+  }
+  page->WLatch();
+  return {bpm_, page};
 }
 
 /*****************************************************************************
@@ -82,22 +229,42 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
+  // Optimistic pass: most inserts fit in their leaf, which is then the only page latched.
+  for (int attempt = 0; attempt < OPTIMISTIC_WRITE_ATTEMPTS; attempt++) {
+    std::optional<WritePageGuard> leaf_guard;
+    if (!TryFindLeafOptimisticWrite(key, &leaf_guard)) {
+      continue;
+    }
+    if (!leaf_guard.has_value()) {
+      break;
+    }
+    auto leaf = leaf_guard->As<LeafPage>();
+    int pos_insert = leaf->Binarysearch(key, comparator_);
+    if (pos_insert < leaf->GetSize() && !comparator_(key, leaf->KeyAt(pos_insert))) {
+      return false;
+    }
+    if (leaf->GetSize() == leaf_max_size_) {
+      break;
+    }
+    leaf_guard->AsMut<LeafPage>()->Insert(key, value, pos_insert);
+    return true;
+  }
+
+  // The tree is empty or the leaf splits: latch down from the header.
   Context ctx;
-  ctx.write_set_.emplace_back(bpm_->FetchPageWrite(header_page_id_));
+  ctx.write_set_.emplace_back(FetchPageWriteWait(header_page_id_));
   auto head = ctx.write_set_.back().AsMut<BPlusTreeHeaderPage>();
   ctx.root_page_id_ = head->root_page_id_;
   if (ctx.root_page_id_ == INVALID_PAGE_ID) {
-    page_id_t leaf_pid{};
-    auto leaf_page = bpm_->NewPageGuarded(&leaf_pid);
-    WritePageGuard guard = bpm_->FetchPageWrite(leaf_pid);
+    page_id_t leaf_pid;
+    WritePageGuard guard = NewPageWriteWait(&leaf_pid);
     auto leaf = reinterpret_cast<LeafPage *>(guard.AsMut<BPlusTreePage>());
     leaf->Init(leaf_max_size_);
     leaf->Insert(key, value, 0);
     head->root_page_id_ = leaf_pid;
     return true;
   }
-  ctx.write_set_.emplace_back(bpm_->FetchPageWrite(ctx.root_page_id_));
+  ctx.write_set_.emplace_back(FetchPageWriteWait(ctx.root_page_id_));
   auto cur_page = ctx.write_set_.back().As<BPlusTreePage>();
   if (cur_page->GetSize() < cur_page->GetMaxSize()) {
     ctx.write_set_.pop_front();
@@ -141,7 +308,7 @@ void BPLUSTREE_TYPE::FindLeaf(Context &ctx, const KeyType &key, const BPlusTreeP
   while (!cur_page->IsLeafPage()) {
     auto internal_page = reinterpret_cast<const InternalPage *>(cur_page);
     ctx.write_set_.emplace_back(
-        bpm_->FetchPageWrite(internal_page->ValueAt(internal_page->Binarysearch(key, comparator_))));
+        FetchPageWriteWait(internal_page->ValueAt(internal_page->Binarysearch(key, comparator_))));
     cur_page = ctx.write_set_.back().As<BPlusTreePage>();
     if (cur_page->GetSize() < cur_page->GetMaxSize()) {
       while (ctx.write_set_.size() > 1) {
@@ -156,7 +323,7 @@ void BPLUSTREE_TYPE::FindLeaf(Context &ctx, const KeyType &key, const BPlusTreeP
   while (!cur_page->IsLeafPage()) {
     auto internal_page = reinterpret_cast<const InternalPage *>(cur_page);
     int pos = internal_page->Binarysearch(key, comparator_);
-    ctx.write_set_.emplace_back(bpm_->FetchPageWrite(internal_page->ValueAt(pos)));
+    ctx.write_set_.emplace_back(FetchPageWriteWait(internal_page->ValueAt(pos)));
     cur_page = ctx.write_set_.back().As<BPlusTreePage>();
     path.emplace_back(pos);
     if (cur_page->GetSize() > cur_page->GetMinSize()) {
@@ -193,8 +360,7 @@ void BPLUSTREE_TYPE::InsertToParent(InternalPage *parent, const KeyType &key, pa
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::CreateNewRoot(Context &ctx, BPlusTreeHeaderPage *root, std::pair<KeyType, page_id_t> KV) {
   page_id_t new_root_id;
-  bpm_->NewPageGuarded(&new_root_id);
-  WritePageGuard root_guard = bpm_->FetchPageWrite(new_root_id);
+  WritePageGuard root_guard = NewPageWriteWait(&new_root_id);
   auto new_root = reinterpret_cast<InternalPage *>(root_guard.AsMut<BPlusTreePage>());
   new_root->Init(internal_max_size_);
   new_root->Insert(KV.first, ctx.root_page_id_, 0);
@@ -206,8 +372,7 @@ void BPLUSTREE_TYPE::CreateNewRoot(Context &ctx, BPlusTreeHeaderPage *root, std:
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::SplitLeaf(LeafPage *leaf1, KeyType key, ValueType value) -> std::pair<KeyType, page_id_t> {
   page_id_t leaf2_pid;
-  auto leaf2_page = bpm_->NewPageGuarded(&leaf2_pid);
-  WritePageGuard leaf2_guard = bpm_->FetchPageWrite(leaf2_pid);
+  WritePageGuard leaf2_guard = NewPageWriteWait(&leaf2_pid);
   auto leaf2 = reinterpret_cast<LeafPage *>(leaf2_guard.AsMut<BPlusTreePage>());
   leaf2->Init(leaf_max_size_);
 
@@ -223,8 +388,7 @@ auto BPLUSTREE_TYPE::SplitLeaf(LeafPage *leaf1, KeyType key, ValueType value) ->
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::SplitInternal(InternalPage *node) -> std::pair<KeyType, page_id_t> {
   page_id_t new_node_pid;
-  auto new_node_page = bpm_->NewPageGuarded(&new_node_pid);
-  WritePageGuard new_node_guard = bpm_->FetchPageWrite(new_node_pid);
+  WritePageGuard new_node_guard = NewPageWriteWait(&new_node_pid);
   auto new_node = reinterpret_cast<InternalPage *>(new_node_guard.AsMut<BPlusTreePage>());
   new_node->Init(internal_max_size_);
 
@@ -244,16 +408,37 @@ auto BPLUSTREE_TYPE::SplitInternal(InternalPage *node) -> std::pair<KeyType, pag
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
+  // Optimistic pass: a leaf that stays at least half full is the only page latched.
+  for (int attempt = 0; attempt < OPTIMISTIC_WRITE_ATTEMPTS; attempt++) {
+    std::optional<WritePageGuard> leaf_guard;
+    if (!TryFindLeafOptimisticWrite(key, &leaf_guard)) {
+      continue;
+    }
+    if (!leaf_guard.has_value()) {
+      return;
+    }
+    auto leaf = leaf_guard->As<LeafPage>();
+    int pos = leaf->Binarysearch(key, comparator_);
+    if (pos >= leaf->GetSize() || comparator_(key, leaf->KeyAt(pos))) {
+      return;
+    }
+    if (leaf->GetSize() <= leaf->GetMinSize()) {
+      break;
+    }
+    leaf_guard->AsMut<LeafPage>()->Remove(pos);
+    return;
+  }
+
+  // The leaf underflows: latch down from the header.
   Context ctx;
   std::vector<int> path;
-  ctx.write_set_.emplace_back(bpm_->FetchPageWrite(header_page_id_));
+  ctx.write_set_.emplace_back(FetchPageWriteWait(header_page_id_));
   auto head = ctx.write_set_.back().AsMut<BPlusTreeHeaderPage>();
   ctx.root_page_id_ = head->root_page_id_;
   if (ctx.root_page_id_ == INVALID_PAGE_ID) {
     return;
   }
-  ctx.write_set_.emplace_back(bpm_->FetchPageWrite(ctx.root_page_id_));
+  ctx.write_set_.emplace_back(FetchPageWriteWait(ctx.root_page_id_));
   auto cur_page = ctx.write_set_.back().As<BPlusTreePage>();
   if (cur_page->GetSize() > cur_page->GetMinSize()) {
     ctx.write_set_.pop_front();
@@ -314,7 +499,7 @@ void BPLUSTREE_TYPE::RemoveHelper(LeafPage *leaf, InternalPage *parent, std::vec
   if (neighbor.first == INVALID_PAGE_ID && neighbor.second == INVALID_PAGE_ID) {
     parent->Remove(idx);
   } else if (neighbor.first != INVALID_PAGE_ID) {
-    WritePageGuard guard = bpm_->FetchPageWrite(neighbor.first);
+    WritePageGuard guard = FetchPageWriteWait(neighbor.first);
     auto left = reinterpret_cast<LeafPage *>(guard.AsMut<BPlusTreePage>());
     if (left->GetSize() > left->GetMinSize()) {
       auto newkey = leaf->Borrow(left, true);
@@ -324,7 +509,7 @@ void BPLUSTREE_TYPE::RemoveHelper(LeafPage *leaf, InternalPage *parent, std::vec
     left->Merge(leaf);
     parent->Remove(idx);
   } else {
-    WritePageGuard guard = bpm_->FetchPageWrite(neighbor.second);
+    WritePageGuard guard = FetchPageWriteWait(neighbor.second);
     auto right = reinterpret_cast<LeafPage *>(guard.AsMut<BPlusTreePage>());
     if (right->GetSize() > right->GetMinSize()) {
       auto newkey = leaf->Borrow(right, false);
@@ -344,7 +529,7 @@ void BPLUSTREE_TYPE::RemoveHelper(InternalPage *node, InternalPage *parent, std:
   if (neighbor.first == INVALID_PAGE_ID && neighbor.second == INVALID_PAGE_ID) {
     parent->Remove(idx);
   } else if (neighbor.first != INVALID_PAGE_ID) {
-    WritePageGuard guard = bpm_->FetchPageWrite(neighbor.first);
+    WritePageGuard guard = FetchPageWriteWait(neighbor.first);
     auto left = reinterpret_cast<InternalPage *>(guard.AsMut<BPlusTreePage>());
     if (left->GetSize() > left->GetMinSize()) {
       auto newkey = node->Borrow(left, true);
@@ -354,7 +539,7 @@ void BPLUSTREE_TYPE::RemoveHelper(InternalPage *node, InternalPage *parent, std:
     left->Merge(node);
     parent->Remove(idx);
   } else {
-    WritePageGuard guard = bpm_->FetchPageWrite(neighbor.second);
+    WritePageGuard guard = FetchPageWriteWait(neighbor.second);
     auto right = reinterpret_cast<InternalPage *>(guard.AsMut<BPlusTreePage>());
     if (right->GetSize() > right->GetMinSize()) {
       auto newkey = node->Borrow(right, false);
@@ -381,12 +566,12 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
   if (current_pid == INVALID_PAGE_ID) {
     return INDEXITERATOR_TYPE(bpm_, INVALID_PAGE_ID, 0);
   }
-  ReadPageGuard current_guard = bpm_->FetchPageRead(current_pid);
+  ReadPageGuard current_guard = FetchPageReadWait(current_pid);
   auto current = current_guard.As<BPlusTreePage>();
   while (current->GetPageType() == IndexPageType::INTERNAL_PAGE) {
     auto node = reinterpret_cast<const InternalPage *>(current);
     current_pid = node->ValueAt(0);
-    current_guard = bpm_->FetchPageRead(current_pid);
+    current_guard = FetchPageReadWait(current_pid);
     current = current_guard.As<BPlusTreePage>();
   }
   return INDEXITERATOR_TYPE(bpm_, current_pid, 0);
@@ -399,23 +584,13 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  auto current_pid = GetRootPageId();
-  if (current_pid == INVALID_PAGE_ID) {
+  std::optional<ReadPageGuard> leaf_guard = FindLeafRead(key);
+  if (!leaf_guard.has_value()) {
     return INDEXITERATOR_TYPE(bpm_, INVALID_PAGE_ID, 0);
   }
-  ReadPageGuard current_guard = bpm_->FetchPageRead(current_pid);
-  auto current = current_guard.As<BPlusTreePage>();
-  int index = 0;
-  while (current->GetPageType() == IndexPageType::INTERNAL_PAGE) {
-    auto node = reinterpret_cast<const InternalPage *>(current);
-    while (comparator_(key, node->KeyAt(index + 1)) >= 0 && index < current->GetSize() - 1) {
-      index++;
-    }
-    current_pid = node->ValueAt(index);
-    current_guard = bpm_->FetchPageRead(current_pid);
-    current = current_guard.As<BPlusTreePage>();
-  }
-  auto leaf = reinterpret_cast<const LeafPage *>(current);
+  auto current_pid = leaf_guard->PageId();
+  auto leaf = leaf_guard->As<LeafPage>();
+  int index;
   for (index = 0; index < leaf->GetSize(); index++) {
     auto current_key = leaf->KeyAt(index);
     if (comparator_(key, current_key) <= 0) {
@@ -436,12 +611,12 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
   if (current_pid == INVALID_PAGE_ID) {
     return INDEXITERATOR_TYPE(bpm_, INVALID_PAGE_ID, 0);
   }
-  ReadPageGuard current_guard = bpm_->FetchPageRead(current_pid);
+  ReadPageGuard current_guard = FetchPageReadWait(current_pid);
   auto current = current_guard.As<BPlusTreePage>();
   while (current->GetPageType() == IndexPageType::INTERNAL_PAGE) {
     auto node = reinterpret_cast<const InternalPage *>(current);
     current_pid = node->ValueAt(current->GetSize() - 1);
-    current_guard = bpm_->FetchPageRead(current_pid);
+    current_guard = FetchPageReadWait(current_pid);
     current = current_guard.As<BPlusTreePage>();
   }
   return INDEXITERATOR_TYPE(bpm_, current_pid, current->GetSize());
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key.cpp
+//
+// Identification: src/storage/index/generic_key.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/generic_key.h"
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Appends bytes to a fixed-size buffer, dropping whatever does not fit. */
+class KeyWriter {
+ public:
+  KeyWriter(char *out, size_t size) : out_(out), size_(size) {}
+
+  void Byte(uint8_t byte) {
+    if (pos_ < size_) {
+      out_[pos_] = static_cast<char>(byte);
+    }
+    pos_++;
+  }
+
+  /** Write the low width bytes of bits, most significant first. */
+  void BigEndian(uint64_t bits, size_t width) {
+    for (size_t i = width; i > 0; i--) {
+      Byte(static_cast<uint8_t>(bits >> (8 * (i - 1))));
+    }
+  }
+
+  /** Invert the bytes written since begin, so the column sorts in reverse. */
+  void Invert(size_t begin) {
+    for (size_t i = begin; i < pos_ && i < size_; i++) {
+      out_[i] = static_cast<char>(~out_[i]);
+    }
+  }
+
+  auto Pos() const -> size_t { return pos_; }
+
+ private:
+  char *out_;
+  size_t size_;
+  size_t pos_{0};
+};
+
+/** Map a signed value of the given width to an unsigned one with the same order. */
+auto FlipSign(int64_t value, size_t width) -> uint64_t {
+  return static_cast<uint64_t>(value) ^ (uint64_t{1} << (8 * width - 1));
+}
+
+}  // namespace
+
+void NormalizeKey(const Tuple &tuple, const Schema &key_schema, uint64_t descending, char *out, size_t size) {
+  memset(out, 0, size);
+  KeyWriter writer(out, size);
+  for (uint32_t i = 0; i < key_schema.GetColumnCount(); i++) {
+    size_t begin = writer.Pos();
+    Value value = tuple.GetValue(&key_schema, i);
+    // NULL fixed-width values hold their type's minimum as a sentinel, so they need no marker byte.
+    switch (key_schema.GetColumn(i).GetType()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        writer.BigEndian(FlipSign(value.GetAs<int8_t>(), 1), 1);
+        break;
+      case TypeId::SMALLINT:
+        writer.BigEndian(FlipSign(value.GetAs<int16_t>(), 2), 2);
+        break;
+      case TypeId::INTEGER:
+        writer.BigEndian(FlipSign(value.GetAs<int32_t>(), 4), 4);
+        break;
+      case TypeId::BIGINT:
+        writer.BigEndian(FlipSign(value.GetAs<int64_t>(), 8), 8);
+        break;
+      case TypeId::TIMESTAMP:
+        // The NULL timestamp is the largest value; shifting by one wraps it around to sort first.
+        writer.BigEndian(value.GetAs<uint64_t>() + 1, 8);
+        break;
+      case TypeId::DECIMAL: {
+        double number = value.GetAs<double>();
+        if (number == 0) {
+          number = 0;  // -0.0 equals 0.0
+        }
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(bits));
+        bits = (bits >> 63) != 0 ? ~bits : bits ^ (uint64_t{1} << 63);
+        writer.BigEndian(bits, 8);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        if (value.IsNull()) {
+          writer.Byte(0);
+          break;
+        }
+        writer.Byte(1);
+        const char *data = value.GetData();
+        uint32_t length = value.GetLength() - 1;  // without the trailing '\0'
+        for (uint32_t j = 0; j < length; j++) {
+          writer.Byte(static_cast<uint8_t>(data[j]));
+          if (data[j] == '\0') {
+            writer.Byte(0xFF);
+          }
+        }
+        writer.Byte(0);
+        writer.Byte(0);
+        break;
+      }
+      default:
+        throw NotImplementedException("unsupported index key type");
+    }
+    if (i < 64 && ((descending >> i) & 1) != 0) {
+      writer.Invert(begin);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -23,7 +23,7 @@ auto INDEXITERATOR_TYPE::IsEnd() -> bool {
   if (cur_page_id_ == INVALID_PAGE_ID) {
     return true;
   }
-  ReadPageGuard read_guard = bpm_->FetchPageRead(cur_page_id_);
+  ReadPageGuard read_guard = bpm_->FetchPageRead(cur_page_id_, AccessType::Scan);
   auto page = read_guard.As<BPlusTreePage>();
   auto leaf_page = reinterpret_cast<const BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(page);
   return (leaf_page->GetNextPageId() == INVALID_PAGE_ID) && (index_ == leaf_page->GetSize());
@@ -31,20 +31,27 @@ auto INDEXITERATOR_TYPE::IsEnd() -> bool {
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
-  ReadPageGuard read_guard = bpm_->FetchPageRead(cur_page_id_);
+  ReadPageGuard read_guard = bpm_->FetchPageRead(cur_page_id_, AccessType::Scan);
   auto page = read_guard.As<BPlusTreePage>();
   auto leaf_page = reinterpret_cast<const BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(page);
-  return leaf_page->KeyValueAt(index_);
+  current_ = leaf_page->KeyValueAt(index_);
+  return current_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  ReadPageGuard read_guard = bpm_->FetchPageRead(cur_page_id_);
+  ReadPageGuard read_guard = bpm_->FetchPageRead(cur_page_id_, AccessType::Scan);
   auto page = read_guard.As<BPlusTreePage>();
   auto leaf_page = reinterpret_cast<const BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(page);
   if (index_ == leaf_page->GetSize() - 1 && leaf_page->GetNextPageId() != INVALID_PAGE_ID) {
     cur_page_id_ = leaf_page->GetNextPageId();
     index_ = 0;
+    read_guard.Drop();
+    if (auto count = read_ahead_.Advance(); count > 0) {
+      bpm_->PrefetchPages(cur_page_id_, count, [](const char *data) {
+        return reinterpret_cast<const BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(data)->GetNextPageId();
+      });
+    }
   } else {
     index_++;
   }
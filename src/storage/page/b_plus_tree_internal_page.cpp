@@ -9,10 +9,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #include "common/config.h"
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
@@ -36,29 +39,35 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // replace with your own code
-  KeyType key = array_[index].first;
+  KeyType key = Keys()[index];
   return key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { Keys()[index] = key; }
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return Values()[index]; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { Values()[index] = value; }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Binarysearch(const KeyType &key, KeyComparator comparator) const -> int {
+  // An optimistic reader may see a torn size; keep the search inside the page.
+  int size = std::clamp<int>(GetSize(), 0, INTERNAL_PAGE_SIZE + 1);
+  if constexpr (SIMD_KEY_SEARCH<KeyType, KeyComparator>) {
+    // The first key is invalid, so this is the number of keys after it that are not above key.
+    return size > 1 ? KeyLowerBound(data_ + sizeof(KeyType), size - 1, sizeof(KeyType), key.data_, true) : 0;
+  }
   int idx = 0;
-  if (GetSize() > 1) {
+  if (size > 1) {
     int l = 1;
-    int r = GetSize() - 1;
+    int r = size - 1;
     while (l <= r) {
       int mid = l + (r - l) / 2;
       int comparation = mid == 0 ? 1 : comparator(key, KeyAt(mid));
@@ -75,18 +84,19 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Binarysearch(const KeyType &key, KeyCompara
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(KeyType key, ValueType value, int index) {
-  for (int i = GetSize(); i > index; --i) {
-    array_[i] = array_[i - 1];
-  }
-  array_[index] = MappingType(key, value);
+  int moved = GetSize() - index;
+  memmove(Keys() + index + 1, Keys() + index, moved * sizeof(KeyType));
+  memmove(Values() + index + 1, Values() + index, moved * sizeof(ValueType));
+  Keys()[index] = key;
+  Values()[index] = value;
   IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
-  for (int i = index; i < GetSize() - 1; ++i) {
-    array_[i] = array_[i + 1];
-  }
+  int moved = GetSize() - index - 1;
+  memmove(Keys() + index, Keys() + index + 1, moved * sizeof(KeyType));
+  memmove(Values() + index, Values() + index + 1, moved * sizeof(ValueType));
   IncreaseSize(-1);
 }
 
@@ -108,9 +118,8 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Merge(BPlusTreeInternalPage *neighbor_node)
   auto neighbor_node_size = neighbor_node->GetSize();
   auto remove = neighbor_node->KeyAt(0);
   IncreaseSize(neighbor_node_size);
-  for (int i = size; i < GetSize(); i++) {
-    this->array_[i] = neighbor_node->array_[i - size];
-  }
+  memcpy(Keys() + size, neighbor_node->Keys(), neighbor_node_size * sizeof(KeyType));
+  memcpy(Values() + size, neighbor_node->Values(), neighbor_node_size * sizeof(ValueType));
   neighbor_node->SetSize(0);
   return remove;
 }
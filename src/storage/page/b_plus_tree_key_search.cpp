@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.cpp
+//
+// Identification: src/storage/page/b_plus_tree_key_search.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BUSTUB_KEY_SEARCH_X86
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** Binary search narrows the range down to this many keys, which are then counted with vector compares. */
+constexpr int SEARCH_WINDOW = 16;
+
+/** Keys are big-endian, so reading them most significant byte first gives an integer in key order. */
+inline auto LoadKey(const char *key, size_t width) -> uint64_t {
+  uint64_t bits = 0;
+  for (size_t i = 0; i < width; i++) {
+    bits = (bits << 8) | static_cast<uint8_t>(key[i]);
+  }
+  return bits;
+}
+
+/** Count the keys below target; as the keys are sorted, this is their lower bound. */
+auto CountBelowScalar(const char *keys, int count, size_t width, uint64_t target) -> int {
+  int below = 0;
+  for (int i = 0; i < count; i++) {
+    below += static_cast<int>(LoadKey(keys + i * width, width) < target);
+  }
+  return below;
+}
+
+#ifdef BUSTUB_KEY_SEARCH_X86
+
+// The vector compares are signed, so both sides get their sign bit flipped to compare as unsigned.
+
+__attribute__((target("avx2"))) auto CountBelowAvx2(const char *keys, int count, size_t width, uint64_t target)
+    -> int {
+  int below = 0;
+  int i = 0;
+  if (width == 8) {
+    const __m256i swap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                          15, 14, 13, 12, 11, 10, 9, 8);
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i bound = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(target)), sign);
+    for (; i + 4 <= count; i += 4) {
+      __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * 8));
+      key = _mm256_xor_si256(_mm256_shuffle_epi8(key, swap), sign);
+      below += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(bound, key))));
+    }
+  } else {
+    const __m256i swap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4,
+                                          11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+    const __m256i bound = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int32_t>(target)), sign);
+    for (; i + 8 <= count; i += 8) {
+      __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * 4));
+      key = _mm256_xor_si256(_mm256_shuffle_epi8(key, swap), sign);
+      below += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(bound, key))));
+    }
+  }
+  return below + CountBelowScalar(keys + i * width, count - i, width, target);
+}
+
+__attribute__((target("sse4.2"))) auto CountBelowSse42(const char *keys, int count, size_t width, uint64_t target)
+    -> int {
+  int below = 0;
+  int i = 0;
+  if (width == 8) {
+    const __m128i swap = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+    const __m128i bound = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(target)), sign);
+    for (; i + 2 <= count; i += 2) {
+      __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i * 8));
+      key = _mm_xor_si128(_mm_shuffle_epi8(key, swap), sign);
+      below += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(bound, key))));
+    }
+  } else {
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m128i sign = _mm_set1_epi32(INT32_MIN);
+    const __m128i bound = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(target)), sign);
+    for (; i + 4 <= count; i += 4) {
+      __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i * 4));
+      key = _mm_xor_si128(_mm_shuffle_epi8(key, swap), sign);
+      below += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(bound, key))));
+    }
+  }
+  return below + CountBelowScalar(keys + i * width, count - i, width, target);
+}
+
+#endif
+
+auto DetectIsa() -> KeySearchIsa {
+#ifdef BUSTUB_KEY_SEARCH_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return KeySearchIsa::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return KeySearchIsa::SSE42;
+  }
+#endif
+  return KeySearchIsa::SCALAR;
+}
+
+const KeySearchIsa KEY_SEARCH_ISA = DetectIsa();
+
+}  // namespace
+
+auto GetKeySearchIsa() -> KeySearchIsa { return KEY_SEARCH_ISA; }
+
+auto KeyLowerBound(const char *keys, int count, size_t width, const char *key, bool upper, KeySearchIsa isa)
+    -> int {
+  uint64_t target = LoadKey(key, width);
+  if (upper) {
+    // The first key above target is the first key at or above target + 1.
+    if (target == (width == 8 ? UINT64_MAX : UINT32_MAX)) {
+      return count;
+    }
+    target++;
+  }
+  int lo = 0;
+  int hi = count;
+  while (hi - lo > SEARCH_WINDOW) {
+    int mid = lo + (hi - lo) / 2;
+    if (LoadKey(keys + mid * width, width) < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  const char *window = keys + lo * width;
+  switch (isa) {
+#ifdef BUSTUB_KEY_SEARCH_X86
+    case KeySearchIsa::AVX2:
+      return lo + CountBelowAvx2(window, hi - lo, width, target);
+    case KeySearchIsa::SSE42:
+      return lo + CountBelowSse42(window, hi - lo, width, target);
+#endif
+    default:
+      return lo + CountBelowScalar(window, hi - lo, width, target);
+  }
+}
+
+}  // namespace bustub
@@ -9,11 +9,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/rid.h"
+#include "storage/page/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/b_plus_tree_page.h"
 #include "type/varlen_type.h"
@@ -52,20 +55,27 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // replace with your own code
-  KeyType key = array_[index].first;
+  KeyType key = Keys()[index];
   return key;
 }
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return Values()[index]; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyValueAt(int index) const -> const MappingType & { return array_[index]; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyValueAt(int index) const -> MappingType {
+  return MappingType(Keys()[index], Values()[index]);
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Binarysearch(const KeyType &key, KeyComparator comparator) const -> int {
+  // An optimistic reader may see a torn size; keep the search inside the page.
+  int size = std::clamp<int>(GetSize(), 0, LEAF_PAGE_SIZE);
+  if constexpr (SIMD_KEY_SEARCH<KeyType, KeyComparator>) {
+    return KeyLowerBound(data_, size, sizeof(KeyType), key.data_, false);
+  }
   int left = 0;
-  int right = GetSize() - 1;
-  int idx = GetSize();
+  int right = size - 1;
+  int idx = size;
   while (left <= right) {
     int mid = left + (right - left) / 2;
     int comparation = comparator(key, KeyAt(mid));
@@ -81,18 +91,19 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Binarysearch(const KeyType &key, KeyComparator
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(KeyType key, ValueType value, int index) {
+  int moved = GetSize() - index;
+  memmove(Keys() + index + 1, Keys() + index, moved * sizeof(KeyType));
+  memmove(Values() + index + 1, Values() + index, moved * sizeof(ValueType));
+  Keys()[index] = key;
+  Values()[index] = value;
   IncreaseSize(1);
-  for (int i = GetSize() - 1; i > index; --i) {
-    array_[i] = array_[i - 1];
-  }
-  array_[index] = MappingType(key, value);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(int index) {
-  for (int i = index; i < GetSize() - 1; ++i) {
-    array_[i] = array_[i + 1];
-  }
+  int moved = GetSize() - index - 1;
+  memmove(Keys() + index, Keys() + index + 1, moved * sizeof(KeyType));
+  memmove(Values() + index, Values() + index + 1, moved * sizeof(ValueType));
   IncreaseSize(-1);
 }
 
@@ -116,9 +127,8 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Merge(BPlusTreeLeafPage *neighbor_leaf) -> KeyT
   auto neighbor_leaf_size = neighbor_leaf->GetSize();
   auto remove = neighbor_leaf->KeyAt(0);
   IncreaseSize(neighbor_leaf_size);
-  for (int i = size; i < GetSize(); i++) {
-    array_[i] = neighbor_leaf->array_[i - size];
-  }
+  memcpy(Keys() + size, neighbor_leaf->Keys(), neighbor_leaf_size * sizeof(KeyType));
+  memcpy(Values() + size, neighbor_leaf->Values(), neighbor_leaf_size * sizeof(ValueType));
   next_page_id_ = neighbor_leaf->GetNextPageId();
   // neighbor_leaf->SetNextPageId(INVALID_PAGE_ID);
   neighbor_leaf->SetSize(0);
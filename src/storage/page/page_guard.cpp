@@ -76,4 +76,33 @@ void WritePageGuard::Drop() {
 
 WritePageGuard::~WritePageGuard() { Drop(); }  // NOLINT
 
+auto OptimisticPageGuard::TryUpgradeRead() -> std::optional<ReadPageGuard> {
+  auto page = guard_.page_;
+  page->RLatch();
+  if (!page->ValidateVersion(version_)) {
+    page->RUnlatch();
+    return std::nullopt;
+  }
+  std::optional<ReadPageGuard> read_guard(std::in_place, guard_.bpm_, page);
+  guard_.bpm_ = nullptr;
+  guard_.page_ = nullptr;
+  guard_.is_dirty_ = false;
+  return read_guard;
+}
+
+auto OptimisticPageGuard::TryUpgradeWrite() -> std::optional<WritePageGuard> {
+  auto page = guard_.page_;
+  page->WLatch();
+  // WLatch() itself bumped the version once.
+  if (!page->ValidateVersion(version_ + 1)) {
+    page->WUnlatch();
+    return std::nullopt;
+  }
+  std::optional<WritePageGuard> write_guard(std::in_place, guard_.bpm_, page);
+  guard_.bpm_ = nullptr;
+  guard_.page_ = nullptr;
+  guard_.is_dirty_ = false;
+  return write_guard;
+}
+
 }  // namespace bustub
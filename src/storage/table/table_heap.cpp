@@ -10,9 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <mutex>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -26,9 +28,9 @@
 
 namespace bustub {
 
-TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
+TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm), extents_(bpm) {
   // Initialize the first table page.
-  auto guard = bpm->NewPageGuarded(&first_page_id_);
+  auto guard = extents_.NewPageGuarded(&first_page_id_);
   last_page_id_ = first_page_id_;
   auto first_page = guard.AsMut<TablePage>();
   BUSTUB_ASSERT(first_page != nullptr,
@@ -50,7 +52,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
 
     page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
+    auto npg = extents_.NewPage(&next_page_id);
     BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
 
     page->SetNextPageId(next_page_id);
@@ -91,14 +93,38 @@ void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   page->UpdateTupleMeta(meta, rid);
 }
 
-auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
-  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+auto TableHeap::GetTuple(RID rid, AccessType access_type) -> std::pair<TupleMeta, Tuple> {
+  auto page_guard = bpm_->FetchPageRead(rid.GetPageId(), access_type);
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
   tuple.rid_ = rid;
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TableHeap::GetTuples(const std::vector<RID> &rids) -> std::vector<std::pair<TupleMeta, Tuple>> {
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(rids.size());
+  for (const auto &rid : rids) {
+    page_ids.push_back(rid.GetPageId());
+  }
+  auto page_guards = bpm_->FetchPagesRead(page_ids);
+  std::vector<std::pair<TupleMeta, Tuple>> tuples;
+  tuples.reserve(rids.size());
+  for (const auto &rid : rids) {
+    // The guards are sorted by page id. A page that is missing could not be fetched in the batch.
+    auto it = std::lower_bound(page_guards.begin(), page_guards.end(), rid.GetPageId(),
+                               [](ReadPageGuard &guard, page_id_t page_id) { return guard.PageId() < page_id; });
+    if (it == page_guards.end() || it->PageId() != rid.GetPageId()) {
+      tuples.push_back(GetTuple(rid));
+      continue;
+    }
+    auto [meta, tuple] = it->As<TablePage>()->GetTuple(rid);
+    tuple.rid_ = rid;
+    tuples.emplace_back(meta, std::move(tuple));
+  }
+  return tuples;
+}
+
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
   auto page = page_guard.As<TablePage>();
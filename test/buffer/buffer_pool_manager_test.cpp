@@ -12,11 +12,19 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/extent_allocator.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/free_list_trunk_page.h"
 
 namespace bustub {
 
@@ -144,4 +152,676 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, IoWithoutLatchTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  // Create twice as many pages as frames, so that the first half only lives on disk.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  const page_id_t resident = page_id_temp;
+  ASSERT_NE(nullptr, bpm->FetchPage(resident));
+
+  disk_manager->SetLatency(500);
+
+  // Scenario: several threads miss on the same page while its dirty victim is written back and it is read in.
+  // They should all end up sharing a single frame.
+  std::atomic<bool> miss_done{false};
+  std::vector<Page *> fetched(4, nullptr);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < fetched.size(); ++i) {
+    threads.emplace_back([&, i] { fetched[i] = bpm->FetchPage(0); });
+  }
+  std::thread waiter([&] {
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    miss_done = true;
+  });
+
+  // Scenario: while the miss is in flight, hits on other pages should not wait for the disk.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100; ++i) {
+    auto *page = bpm->FetchPage(resident);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(resident)).c_str()));
+    EXPECT_TRUE(bpm->UnpinPage(resident, false));
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_FALSE(miss_done);
+  EXPECT_LT(elapsed, std::chrono::milliseconds(300));
+
+  waiter.join();
+  for (auto *page : fetched) {
+    ASSERT_EQ(fetched[0], page);
+  }
+  EXPECT_EQ(0, strcmp(fetched[0]->GetData(), "page 0"));
+  EXPECT_EQ(static_cast<int>(fetched.size()), fetched[0]->GetPinCount());
+  for (size_t i = 0; i < fetched.size(); ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(0, false));
+  }
+  EXPECT_TRUE(bpm->UnpinPage(resident, false));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundWriterTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  // Fill the pool with dirty, unpinned pages. Pages 0-3 are the coldest ones.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  auto is_dirty = [&](page_id_t page_id) {
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      if (bpm->GetPages()[i].GetPageId() == page_id) {
+        return bpm->GetPages()[i].IsDirty();
+      }
+    }
+    ADD_FAILURE() << "page " << page_id << " is not resident";
+    return false;
+  };
+
+  // Scenario: the writer cleans the four coldest pages, two per round, and leaves the others dirty.
+  bpm->StartBackgroundWriter(4, 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  bpm->StopBackgroundWriter();
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    EXPECT_EQ(page_id >= 4, is_dirty(page_id)) << "page " << page_id;
+  }
+
+  // Scenario: the cleaned pages are evicted next, without write-back, and their contents survive on disk.
+  disk_manager->SetLatency(500);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+  disk_manager->SetLatency(0);
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    auto guard = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(0, strcmp(guard.GetData(), ("page " + std::to_string(page_id)).c_str()));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundWriterFlushTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  // Page 0 is the only dirty page, so it is the one the background writer picks.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "old %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, page_id_temp == 0));
+  }
+
+  // Scenario: while a slow background write of page 0 is in flight, the page is modified and flushed with fast writes.
+  // The modification waits for the background write, so the older image cannot land on disk after the flushed one.
+  disk_manager->SetLatency(300);
+  bpm->StartBackgroundWriter(buffer_pool_size, buffer_pool_size);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  disk_manager->SetLatency(0);
+  {
+    auto guard = bpm->FetchPageWrite(0);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "new 0");
+  }
+  EXPECT_TRUE(bpm->FlushPage(0));
+  bpm->StopBackgroundWriter();
+
+  // Scenario: page 0 is clean, so it would be evicted without a write; the disk must hold the new image.
+  EXPECT_FALSE(bpm->GetPages()[0].IsDirty());
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(0, data);
+  EXPECT_EQ(0, strcmp(data, "new 0"));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const size_t buffer_pool_size = 64;
+  const size_t chain_length = 8;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+  // Build a chain of pages, each storing the id of the next one in its first bytes, and push it out of the pool.
+  std::vector<page_id_t> chain(chain_length);
+  for (size_t i = 0; i < chain_length; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&chain[i]));
+  }
+  for (size_t i = 0; i < chain_length; ++i) {
+    auto guard = bpm->FetchPageWrite(chain[i]);
+    *guard.AsMut<page_id_t>() = i + 1 < chain_length ? chain[i + 1] : INVALID_PAGE_ID;
+    snprintf(guard.AsMut<char>() + sizeof(page_id_t), BUSTUB_PAGE_SIZE - sizeof(page_id_t), "page %d", chain[i]);
+    EXPECT_TRUE(bpm->UnpinPage(chain[i], true));
+  }
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  auto next_page_id = [](const char *data) { return *reinterpret_cast<const page_id_t *>(data); };
+
+  // Scenario: read-ahead returns right away and loads the whole chain in the background.
+  disk_manager->SetLatency(50);
+  auto start = std::chrono::steady_clock::now();
+  bpm->PrefetchPages(chain[0], chain_length, next_page_id);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50 * chain_length + 200));
+
+  // Scenario: every page of the chain is now resident and intact.
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < chain_length; ++i) {
+    auto guard = bpm->FetchPageRead(chain[i]);
+    EXPECT_EQ(0, strcmp(guard.GetData() + sizeof(page_id_t), ("page " + std::to_string(chain[i])).c_str()));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+  disk_manager->SetLatency(0);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DeletePageReuseTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+  page_id_t page_ids[5];
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: deleted pages, resident or not, are handed out again before the file grows, most recent first.
+  EXPECT_TRUE(bpm->DeletePage(page_ids[1]));
+  EXPECT_TRUE(bpm->DeletePage(page_ids[3]));
+  bpm->FlushAllPages();
+  page_id_t page_id;
+  auto *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(page_ids[3], page_id);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[1], page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[4] + 1, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // Scenario: ids that were never allocated are not put on the free list.
+  EXPECT_TRUE(bpm->DeletePage(1000));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[4] + 2, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // Scenario: a page deleted twice, the second time when it is no longer resident, is handed out only once.
+  EXPECT_TRUE(bpm->DeletePage(page_ids[0]));
+  EXPECT_TRUE(bpm->DeletePage(page_ids[0]));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[0], page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[4] + 3, page_id);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FreePagesRestartTest) {
+  const std::string db_name = "free_pages_restart_test.db";
+  const size_t buffer_pool_size = 10;
+  remove(db_name.c_str());
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  page_id_t page_ids[5];
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  EXPECT_TRUE(bpm->DeletePage(page_ids[1]));
+  EXPECT_TRUE(bpm->DeletePage(page_ids[3]));
+  bpm->FlushAllPages();
+  // Changes after the last FlushAllPages() are lost.
+  EXPECT_TRUE(bpm->DeletePage(page_ids[0]));
+  bpm.reset();
+  disk_manager->ShutDown();
+
+  // Scenario: a buffer pool on a reopened database file reuses the pages that were free at the last FlushAllPages(),
+  // and then goes on with fresh ids where the old one stopped.
+  disk_manager = std::make_unique<DiskManager>(db_name);
+  bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[3], page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[1], page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[4] + 1, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  bpm.reset();
+  disk_manager->ShutDown();
+
+  // Scenario: the saved state belongs to the database file, so a new file starts from scratch.
+  remove(db_name.c_str());
+  disk_manager = std::make_unique<DiskManager>(db_name);
+  bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove((db_name + ".meta").c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FreeListTrunkReadTest) {
+  const size_t buffer_pool_size = 10;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  const auto num_pages = static_cast<page_id_t>(FreeListTrunkPage::CAPACITY + 2);
+  {
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+    page_id_t page_id;
+    for (page_id_t i = 0; i < num_pages; i++) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+    for (page_id_t i = 0; i < num_pages; i++) {
+      EXPECT_TRUE(bpm->DeletePage(i));
+    }
+    bpm->FlushAllPages();
+  }
+
+  // Scenario: when the free list gets to a trunk page that is only on disk, the page is read in the background,
+  // with fresh pages handed out meanwhile, and every free page is still reused in the end.
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  page_id_t page_id;
+  page_id_t reused = 0;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (reused < num_pages && std::chrono::steady_clock::now() < deadline) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    if (page_id < num_pages) {
+      reused++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  EXPECT_EQ(num_pages, reused);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ExtentAllocatorTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  ExtentAllocator table(bpm.get());
+  ExtentAllocator index(bpm.get());
+
+  // Scenario: two objects growing at the same time, with other pages created in between, each get consecutive ids.
+  std::vector<page_id_t> table_pages;
+  std::vector<page_id_t> index_pages;
+  std::vector<page_id_t> other_pages;
+  for (int i = 0; i < DISK_EXTENT_PAGES + 3; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, table.NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    table_pages.push_back(page_id);
+    ASSERT_NE(nullptr, index.NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    index_pages.push_back(page_id);
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    other_pages.push_back(page_id);
+  }
+  for (int i = 1; i < DISK_EXTENT_PAGES; i++) {
+    EXPECT_EQ(table_pages[0] + i, table_pages[i]);
+    EXPECT_EQ(index_pages[0] + i, index_pages[i]);
+  }
+  for (int i = DISK_EXTENT_PAGES + 1; i < DISK_EXTENT_PAGES + 3; i++) {
+    EXPECT_EQ(table_pages[DISK_EXTENT_PAGES] + i - DISK_EXTENT_PAGES, table_pages[i]);
+  }
+
+  // Scenario: no page id is handed out twice.
+  std::vector<page_id_t> all_pages(table_pages);
+  all_pages.insert(all_pages.end(), index_pages.begin(), index_pages.end());
+  all_pages.insert(all_pages.end(), other_pages.begin(), other_pages.end());
+  std::sort(all_pages.begin(), all_pages.end());
+  EXPECT_EQ(all_pages.end(), std::adjacent_find(all_pages.begin(), all_pages.end()));
+
+  // Scenario: pages created at a reserved id can be fetched back like any other.
+  {
+    auto guard = bpm->FetchPageRead(table_pages.back());
+    EXPECT_NE(nullptr, guard.GetData());
+  }
+
+  // Scenario: when the pool has no free frame, no page is created and the next one still comes from the extent. The id
+  // that could not be used is freed, so it is handed out again instead of leaving a hole.
+  std::vector<page_id_t> pinned(buffer_pool_size);
+  for (auto &page_id : pinned) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  page_id_t page_id = INVALID_PAGE_ID;
+  EXPECT_EQ(nullptr, table.NewPage(&page_id));
+  EXPECT_EQ(INVALID_PAGE_ID, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(pinned[0], false));
+  ASSERT_NE(nullptr, table.NewPage(&page_id));
+  EXPECT_EQ(table_pages.back() + 2, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(table_pages.back() + 1, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // Scenario: an object that needs a new extent reuses deleted pages first, and reserves extents again afterwards.
+  ExtentAllocator other(bpm.get());
+  EXPECT_TRUE(bpm->DeletePage(other_pages[0]));
+  ASSERT_NE(nullptr, other.NewPage(&page_id));
+  EXPECT_EQ(other_pages[0], page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  page_id_t first_page_id;
+  ASSERT_NE(nullptr, other.NewPage(&first_page_id));
+  EXPECT_TRUE(bpm->UnpinPage(first_page_id, false));
+  ASSERT_NE(nullptr, other.NewPage(&page_id));
+  EXPECT_EQ(first_page_id + 1, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FlushDirtyPagesTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  auto page_writes = [&] { return disk_manager->GetNumWrites(); };
+
+  page_id_t page_id;
+  for (int i = 0; i < 8; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  bpm->FlushAllPages();
+  auto writes = page_writes();
+
+  // Scenario: only the dirty and the pinned pages in the range are written; adjacent ones share a write.
+  for (page_id_t dirty_page_id : {1, 2, 3, 6}) {
+    auto *page = bpm->FetchPage(dirty_page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", dirty_page_id);
+    EXPECT_TRUE(bpm->UnpinPage(dirty_page_id, true));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(4));
+  bpm->FlushDirtyPages(2, 7);
+  EXPECT_EQ(writes + 4, page_writes());
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(6, data);
+  EXPECT_STREQ("page 6", data);
+
+  // Scenario: written pages are clean afterwards, but a pinned page is written again.
+  bpm->FlushAllPages();
+  EXPECT_EQ(writes + 6, page_writes());
+  disk_manager->ReadPage(1, data);
+  EXPECT_STREQ("page 1", data);
+  EXPECT_TRUE(bpm->UnpinPage(4, false));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FlushWithoutLatchTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+  page_id_t page_id;
+  for (int i = 0; i < 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: a flush of a page that is being written waits for the writer, so no half-written image reaches disk.
+  std::atomic<bool> flushed{false};
+  std::thread flusher;
+  {
+    auto guard = bpm->FetchPageWrite(0);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "half");
+    flusher = std::thread([&] {
+      EXPECT_TRUE(bpm->FlushPage(0));
+      flushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(flushed);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "full");
+  }
+  flusher.join();
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(0, data);
+  EXPECT_STREQ("full", data);
+
+  // Scenario: while a flush waits for the disk, the rest of the pool goes on without it.
+  disk_manager->SetLatency(300);
+  flusher = std::thread([&] { EXPECT_TRUE(bpm->FlushPage(1)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+  flusher.join();
+  disk_manager->SetLatency(0);
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t max_pool_size = 8;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), LRUK_REPLACER_K, nullptr,
+                                                 ReplacerType::LRUK, max_pool_size);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+  EXPECT_EQ(max_pool_size, bpm->GetMaxPoolSize());
+  EXPECT_FALSE(bpm->Resize(0));
+  EXPECT_FALSE(bpm->Resize(max_pool_size + 1));
+
+  // Scenario: after growing, the pool holds max_pool_size pinned pages and no more.
+  ASSERT_TRUE(bpm->Resize(max_pool_size));
+  EXPECT_EQ(max_pool_size, bpm->GetPoolSize());
+  page_id_t page_ids[max_pool_size];
+  for (auto &page_id : page_ids) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  // Scenario: shrinking waits for the pages in the retired frames, then writes back the dirty ones.
+  std::thread unpinner([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (auto id : page_ids) {
+      EXPECT_TRUE(bpm->UnpinPage(id, true));
+    }
+  });
+  ASSERT_TRUE(bpm->Resize(2));
+  unpinner.join();
+  EXPECT_EQ(2, bpm->GetPoolSize());
+  for (auto id : page_ids) {
+    auto *page = bpm->FetchPage(id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(id, false));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[2]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[1], false));
+
+  // Scenario: readers keep going while the pool is resized under them.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&, t] {
+      std::mt19937 gen(t);
+      while (!done) {
+        auto id = page_ids[gen() % max_pool_size];
+        auto *page = bpm->FetchPage(id);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ("page " + std::to_string(id), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(id, gen() % 2 == 0));
+      }
+    });
+  }
+  for (size_t new_size : {8, 5, 8, 4, 7}) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_TRUE(bpm->Resize(new_size));
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(7, bpm->GetPoolSize());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, HotSetTest) {
+  const size_t num_pages = 6;
+  const std::string hot_set_file("hot_set_test.hot");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  page_id_t page_ids[num_pages];
+  {
+    auto bpm = std::make_unique<BufferPoolManager>(8, disk_manager.get(), 2);
+    for (auto &page_id : page_ids) {
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    }
+    // The last page stays pinned, the third one is accessed three more times.
+    for (size_t i = 0; i < num_pages - 1; i++) {
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+    }
+    for (int i = 0; i < 3; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_ids[2]));
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[2], false));
+    }
+
+    // Scenario: the pinned page is the hottest, the evictable ones follow from the last to the next victim.
+    ASSERT_TRUE(bpm->DumpHotSet(hot_set_file));
+    std::vector<HotPage> pages;
+    ASSERT_TRUE(HotSetFile::Read(hot_set_file, &pages));
+    ASSERT_EQ(num_pages, pages.size());
+    EXPECT_EQ(page_ids[5], pages[0].page_id_);
+    EXPECT_EQ(page_ids[2], pages[1].page_id_);
+    EXPECT_EQ(2, pages[1].accesses_);  // LRU-K counts no more than k accesses
+    EXPECT_EQ(page_ids[4], pages[2].page_id_);
+    EXPECT_EQ(page_ids[0], pages[5].page_id_);
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[5], true));
+    bpm->FlushAllPages();
+  }
+
+  // Scenario: a smaller buffer pool loads the hottest pages that fit, and only once.
+  auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager.get(), 2);
+  EXPECT_EQ(0, bpm->LoadHotSet("missing.hot"));
+  EXPECT_EQ(4, bpm->LoadHotSet(hot_set_file));
+  EXPECT_EQ(0, bpm->LoadHotSet(hot_set_file));
+  EXPECT_EQ(4, bpm->GetMetrics().prefetches_);
+
+  // Scenario: the coldest loaded page is evicted first, and new pages are not allocated over the loaded ones.
+  page_id_t new_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&new_page_id));
+  EXPECT_GT(new_page_id, page_ids[5]);
+  for (auto i : {2, 4, 5}) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  auto metrics = bpm->GetMetrics();
+  EXPECT_EQ(0, metrics.misses_[0] + metrics.misses_[1] + metrics.misses_[2]);
+  auto *page = bpm->FetchPage(page_ids[3]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(page_ids[3]), std::string(page->GetData()));
+  EXPECT_EQ(1, bpm->GetMetrics().misses_[0]);
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[3], false));
+  EXPECT_TRUE(bpm->UnpinPage(new_page_id, false));
+
+  std::remove(hot_set_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FetchPagesTest) {
+  const size_t buffer_pool_size = 6;
+  const size_t num_pages = 8;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), LRUK_REPLACER_K);
+  page_id_t page_ids[num_pages];
+  for (auto &page_id : page_ids) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: repeated ids are fetched once, the guards come back sorted, and every miss is read from disk.
+  auto before = bpm->GetMetrics();
+  {
+    auto guards = bpm->FetchPagesRead({page_ids[7], page_ids[0], page_ids[1], page_ids[0], page_ids[6]});
+    ASSERT_EQ(4, guards.size());
+    page_id_t expected[] = {page_ids[0], page_ids[1], page_ids[6], page_ids[7]};
+    for (size_t i = 0; i < guards.size(); i++) {
+      EXPECT_EQ(expected[i], guards[i].PageId());
+      EXPECT_EQ("page " + std::to_string(expected[i]), std::string(guards[i].GetData()));
+    }
+    auto after = bpm->GetMetrics();
+    EXPECT_EQ(2, after.hits_[0] - before.hits_[0]);
+    EXPECT_EQ(2, after.misses_[0] - before.misses_[0]);
+  }
+
+  // Scenario: with more pages than frames, the batch pins what fits and leaves the rest out.
+  {
+    std::vector<page_id_t> all(page_ids, page_ids + num_pages);
+    auto guards = bpm->FetchPagesRead(all);
+    ASSERT_EQ(buffer_pool_size, guards.size());
+    for (auto &guard : guards) {
+      EXPECT_EQ("page " + std::to_string(guard.PageId()), std::string(guard.GetData()));
+    }
+    page_id_t page_id;
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  }
+
+  // Scenario: all pages are unpinned once the guards are gone.
+  for (auto id : page_ids) {
+    auto *page = bpm->FetchPage(id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_TRUE(bpm->UnpinPage(id, false));
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,81 @@
+/**
+ * buffer_pool_metrics_test.cpp
+ */
+
+#include "buffer/buffer_pool_metrics.h"
+
+#include <chrono>
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/metrics.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+TEST(BufferPoolMetricsTest, HistogramTest) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.Snapshot().PercentileNs(50));
+
+  // Scenario: 99 fast samples and one slow one; percentiles report the end of the bucket they fall in.
+  for (int i = 0; i < 99; i++) {
+    histogram.Record(std::chrono::nanoseconds(1000));
+  }
+  histogram.Record(std::chrono::milliseconds(1));
+  auto snapshot = histogram.Snapshot();
+  EXPECT_EQ(100, snapshot.count_);
+  EXPECT_EQ((99 * 1000 + 1000000) / 100, snapshot.MeanNs());
+  EXPECT_EQ(1024, snapshot.PercentileNs(50));
+  EXPECT_EQ(1024, snapshot.PercentileNs(99));
+  EXPECT_EQ(1 << 20, snapshot.PercentileNs(100));
+
+  // Scenario: merging two snapshots adds up their samples.
+  snapshot.Merge(histogram.Snapshot());
+  EXPECT_EQ(200, snapshot.count_);
+  EXPECT_EQ(1024, snapshot.PercentileNs(99));
+}
+
+TEST(BufferPoolMetricsTest, BufferPoolTest) {
+  const size_t buffer_pool_size = 3;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+  // Scenario: filling the pool creates pages without touching the disk.
+  page_id_t page_ids[buffer_pool_size + 1];
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_ids[i]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], true));
+  }
+  auto metrics = bpm->GetMetrics();
+  EXPECT_EQ(buffer_pool_size, metrics.new_pages_);
+  EXPECT_EQ(0, metrics.evictions_);
+
+  // Scenario: one more page evicts a dirty victim, which has to be written back first.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[buffer_pool_size]));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[buffer_pool_size], false));
+  metrics = bpm->GetMetrics();
+  EXPECT_EQ(1, metrics.evictions_);
+  EXPECT_EQ(1, metrics.dirty_write_backs_);
+  EXPECT_EQ(1, metrics.write_back_latency_.count_);
+
+  // Scenario: fetching the evicted page is a miss, fetching it again is a hit; both are counted by access type.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0], AccessType::Get));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[0], false, AccessType::Get));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0], AccessType::Scan));
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[0], false, AccessType::Scan));
+  metrics = bpm->GetMetrics();
+  EXPECT_EQ(1, metrics.misses_[AccessTypeIndex(AccessType::Get)]);
+  EXPECT_EQ(1, metrics.miss_latency_[AccessTypeIndex(AccessType::Get)].count_);
+  EXPECT_EQ(1, metrics.hits_[AccessTypeIndex(AccessType::Scan)]);
+  EXPECT_EQ(0, metrics.hits_[AccessTypeIndex(AccessType::Get)]);
+  EXPECT_EQ(2, metrics.evictions_);
+  EXPECT_DOUBLE_EQ(0.5, metrics.HitRatio());
+
+  // Scenario: the page reads and writes show up in the disk metrics.
+  auto disk_metrics = disk_manager->GetMetrics();
+  EXPECT_EQ(1, disk_metrics.read_latency_.count_);
+  EXPECT_LE(1, disk_metrics.write_latency_.count_);
+}
+
+}  // namespace bustub
@@ -19,7 +19,7 @@
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -59,4 +59,28 @@ TEST(ClockReplacerTest, DISABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, ScanTest) {
+  ClockReplacer clock_replacer(6);
+
+  // Scenario: frames 0 and 1 are read by point lookups, frames 2-5 only by a sequential scan.
+  clock_replacer.RecordAccess(0, AccessType::Get);
+  clock_replacer.RecordAccess(1, AccessType::Get);
+  for (frame_id_t frame_id = 2; frame_id < 6; frame_id++) {
+    clock_replacer.RecordAccess(frame_id, AccessType::Scan);
+  }
+  EXPECT_EQ(6, clock_replacer.Size());
+
+  // Scenario: the scanned frames never got a reference bit, so the first sweep evicts them before the others.
+  int value;
+  for (frame_id_t frame_id = 2; frame_id < 6; frame_id++) {
+    ASSERT_TRUE(clock_replacer.Evict(&value));
+    EXPECT_EQ(frame_id, value);
+  }
+  ASSERT_TRUE(clock_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  clock_replacer.Remove(1);
+  EXPECT_EQ(0, clock_replacer.Size());
+  EXPECT_FALSE(clock_replacer.Evict(&value));
+}
+
 }  // namespace bustub
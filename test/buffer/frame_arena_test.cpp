@@ -0,0 +1,58 @@
+/**
+ * frame_arena_test.cpp
+ */
+
+#include "buffer/frame_arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+TEST(FrameArenaTest, SampleTest) {
+  const size_t num_frames = 16;
+  FrameArena arena(num_frames);
+
+  // Scenario: frames are zeroed, page-aligned and laid out back to back.
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(num_frames); frame_id++) {
+    char *frame = arena.GetFrame(frame_id);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(frame) % BUSTUB_PAGE_SIZE);
+    EXPECT_EQ(arena.GetFrame(0) + frame_id * BUSTUB_PAGE_SIZE, frame);
+    for (size_t i = 0; i < BUSTUB_PAGE_SIZE; i++) {
+      ASSERT_EQ(0, frame[i]);
+    }
+  }
+
+  // Scenario: every byte of every frame is writable without touching the other frames.
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(num_frames); frame_id++) {
+    memset(arena.GetFrame(frame_id), frame_id + 1, BUSTUB_PAGE_SIZE);
+  }
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(num_frames); frame_id++) {
+    EXPECT_EQ(frame_id + 1, arena.GetFrame(frame_id)[0]);
+    EXPECT_EQ(frame_id + 1, arena.GetFrame(frame_id)[BUSTUB_PAGE_SIZE - 1]);
+  }
+
+  // Scenario: an arena large enough for huge pages still hands out ordinary frames.
+  FrameArena large_arena(HUGE_PAGE_SIZE / BUSTUB_PAGE_SIZE + 1);
+  large_arena.GetFrame(HUGE_PAGE_SIZE / BUSTUB_PAGE_SIZE)[BUSTUB_PAGE_SIZE - 1] = 1;
+}
+
+TEST(FrameArenaTest, BufferPoolTest) {
+  const size_t buffer_pool_size = 8;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+
+  // Scenario: the pages of a buffer pool point into one contiguous, aligned arena.
+  auto *pages = bpm->GetPages();
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(pages[0].GetData() + i * BUSTUB_PAGE_SIZE, pages[i].GetData());
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[i].GetData()) % BUSTUB_PAGE_SIZE);
+  }
+}
+
+}  // namespace bustub
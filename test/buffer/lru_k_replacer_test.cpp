@@ -95,4 +95,72 @@ TEST(LRUKReplacerTest, SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, ScanTest) {
+  LRUKReplacer lru_replacer(8, 2);
+
+  // Scenario: frames 0 and 1 are hot, frame 2 has been read once, and frames 3-7 are touched by a sequential scan.
+  lru_replacer.RecordAccess(0, AccessType::Get);
+  lru_replacer.RecordAccess(0, AccessType::Get);
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Get);
+  for (frame_id_t frame_id = 3; frame_id < 8; frame_id++) {
+    lru_replacer.RecordAccess(frame_id, AccessType::Scan);
+  }
+  // Scanning a frame again does not make it hotter, and scanning a hot frame does not make it colder.
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(0, AccessType::Scan);
+  ASSERT_EQ(8, lru_replacer.Size());
+
+  // Scenario: frame 7 is pinned and unpinned again; it goes back to the cold end. Frame 6 is then read by a point
+  // lookup, so it is no longer treated as scanned.
+  lru_replacer.SetEvictable(7, false);
+  lru_replacer.SetEvictable(7, true);
+  lru_replacer.RecordAccess(6, AccessType::Get);
+
+  // Scenario: the scanned frames go first, then the frames with fewer than k accesses, then the hot frames.
+  std::set<frame_id_t> scanned;
+  int value;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    scanned.insert(value);
+  }
+  ASSERT_EQ((std::set<frame_id_t>{3, 4, 5, 7}), scanned);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(6, value);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_FALSE(lru_replacer.Evict(&value));
+}
+
+TEST(LRUKReplacerTest, ReturnVictimTest) {
+  LRUKReplacer lru_replacer(4, 2);
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    lru_replacer.RecordAccess(frame_id);
+    lru_replacer.RecordAccess(frame_id);
+  }
+
+  // Scenario: the two coldest frames are taken out while they are written back. They cannot be evicted meanwhile.
+  std::vector<frame_id_t> victims;
+  lru_replacer.PeekVictims(2, &victims);
+  ASSERT_EQ((std::vector<frame_id_t>{0, 1}), victims);
+  lru_replacer.SetEvictable(0, false);
+  lru_replacer.SetEvictable(1, false);
+  ASSERT_EQ(2, lru_replacer.Size());
+
+  // Scenario: returned coldest last, they are evicted first again, in their old order.
+  lru_replacer.ReturnVictim(1);
+  lru_replacer.ReturnVictim(0);
+  ASSERT_EQ(4, lru_replacer.Size());
+  int value;
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    ASSERT_EQ(frame_id, value);
+  }
+}
 }  // namespace bustub
@@ -0,0 +1,123 @@
+/**
+ * page_table_test.cpp
+ */
+
+#include "buffer/page_table.h"
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(8);
+  frame_id_t frame_id;
+
+  // Scenario: a fresh table maps nothing.
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+  EXPECT_FALSE(page_table.Erase(0));
+
+  // Scenario: insert a few mappings and look them up again.
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    page_table.Insert(page_id, static_cast<frame_id_t>(7 - page_id));
+  }
+  EXPECT_EQ(8, page_table.Size());
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    ASSERT_TRUE(page_table.Find(page_id, &frame_id));
+    EXPECT_EQ(7 - page_id, frame_id);
+  }
+  EXPECT_FALSE(page_table.Find(8, &frame_id));
+
+  // Scenario: erasing a mapping leaves the others reachable, and the page can be mapped again.
+  EXPECT_TRUE(page_table.Erase(3));
+  EXPECT_FALSE(page_table.Erase(3));
+  EXPECT_FALSE(page_table.Find(3, &frame_id));
+  EXPECT_EQ(7, page_table.Size());
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    if (page_id != 3) {
+      ASSERT_TRUE(page_table.Find(page_id, &frame_id));
+      EXPECT_EQ(7 - page_id, frame_id);
+    }
+  }
+  page_table.Insert(3, 0);
+  ASSERT_TRUE(page_table.Find(3, &frame_id));
+  EXPECT_EQ(0, frame_id);
+}
+
+TEST(PageTableTest, ChurnTest) {
+  // Scenario: random inserts and erases at the maximum load must agree with a reference map. Every erase shifts
+  // entries of long probe runs backwards, so this exercises the wrap-around cases as well.
+  const size_t num_frames = 64;
+  PageTable page_table(num_frames);
+  std::unordered_map<page_id_t, frame_id_t> reference;
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<page_id_t> page_dist(0, 1000);
+
+  for (int round = 0; round < 20000; round++) {
+    page_id_t page_id = page_dist(gen);
+    if (reference.count(page_id) == 0 && reference.size() < num_frames * 2) {
+      auto frame_id = static_cast<frame_id_t>(round % num_frames);
+      page_table.Insert(page_id, frame_id);
+      reference[page_id] = frame_id;
+    } else {
+      EXPECT_EQ(reference.erase(page_id) == 1, page_table.Erase(page_id));
+    }
+  }
+  EXPECT_EQ(reference.size(), page_table.Size());
+  for (page_id_t page_id = 0; page_id <= 1000; page_id++) {
+    frame_id_t frame_id;
+    auto it = reference.find(page_id);
+    ASSERT_EQ(it != reference.end(), page_table.Find(page_id, &frame_id));
+    if (it != reference.end()) {
+      EXPECT_EQ(it->second, frame_id);
+    }
+  }
+}
+
+TEST(PageTableTest, ConcurrentFindTest) {
+  // Scenario: lock-free readers race with a writer that keeps mapping and unmapping other pages. A reader may miss an
+  // entry that is being shifted, but it must never see a page mapped to a frame it was not inserted with.
+  const size_t num_frames = 32;
+  const page_id_t num_stable = 16;
+  PageTable page_table(num_frames);
+  for (page_id_t page_id = 0; page_id < num_stable; page_id++) {
+    page_table.Insert(page_id, page_id);
+  }
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; tid++) {
+    readers.emplace_back([&] {
+      while (!done) {
+        for (page_id_t page_id = 0; page_id < num_stable * 2; page_id++) {
+          frame_id_t frame_id;
+          if (page_table.Find(page_id, &frame_id)) {
+            EXPECT_EQ(page_id < num_stable ? page_id : page_id - num_stable, frame_id);
+          }
+        }
+      }
+    });
+  }
+
+  for (int round = 0; round < 2000; round++) {
+    for (page_id_t page_id = num_stable; page_id < num_stable * 2; page_id++) {
+      page_table.Insert(page_id, page_id - num_stable);
+    }
+    for (page_id_t page_id = num_stable; page_id < num_stable * 2; page_id++) {
+      EXPECT_TRUE(page_table.Erase(page_id));
+    }
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(num_stable, page_table.Size());
+}
+
+}  // namespace bustub
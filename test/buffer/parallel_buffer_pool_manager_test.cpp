@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/extent_allocator.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const size_t num_instances = 5;
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get(), k);
+  EXPECT_EQ(num_instances * buffer_pool_size, bpm->GetPoolSize());
+
+  // Scenario: new pages are handed out round-robin, so each shard allocates from its own residue class.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(bpm->GetBufferPoolManager(page_id_temp), bpm->GetBufferPoolManager(page_id_temp + num_instances));
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+  }
+
+  // Scenario: once every shard is full of pinned pages, we should not be able to create any new pages.
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: unpinning pages frees frames in the shards that own them.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_instances * buffer_pool_size); ++page_id) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    EXPECT_FALSE(bpm->UnpinPage(page_id, true));
+  }
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+
+  // Scenario: we should be able to fetch the data we wrote a while ago, through plain pages and page guards.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_instances * buffer_pool_size); ++page_id) {
+    auto guard = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(0, strcmp(guard.GetData(), ("page " + std::to_string(page_id)).c_str()));
+  }
+  auto *page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "page 0"));
+  EXPECT_FALSE(bpm->DeletePage(0));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->DeletePage(0));
+  bpm->FlushAllPages();
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 8;
+  const size_t num_threads = 8;
+  const size_t rounds = 200;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get());
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_instances * buffer_pool_size * 2; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] {
+      for (size_t i = 0; i < rounds; ++i) {
+        page_id_t page_id = page_ids[(tid + i * num_threads) % page_ids.size()];
+        auto guard = bpm->FetchPageRead(page_id);
+        EXPECT_EQ(0, strcmp(guard.GetData(), ("page " + std::to_string(page_id)).c_str()));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ExtentAllocatorTest) {
+  const size_t num_instances = 3;
+  const size_t buffer_pool_size = 8;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get());
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 5; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: an extent spans all shards, and its pages are created in the shards that own them.
+  ExtentAllocator extents(bpm.get());
+  std::vector<page_id_t> extent_pages;
+  for (size_t i = 0; i < num_instances * 2; i++) {
+    page_id_t page_id;
+    auto guard = extents.NewPageGuarded(&page_id);
+    ASSERT_NE(nullptr, guard.GetData());
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    extent_pages.push_back(page_id);
+  }
+  for (size_t i = 1; i < extent_pages.size(); i++) {
+    EXPECT_EQ(extent_pages[0] + static_cast<page_id_t>(i), extent_pages[i]);
+  }
+  for (auto page_id : extent_pages) {
+    auto guard = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(0, strcmp(guard.GetData(), ("page " + std::to_string(page_id)).c_str()));
+  }
+
+  // Scenario: ids the shards skipped to get past the extent are handed out again; none collides with the extent.
+  for (size_t i = 0; i < num_instances * 4 + DISK_EXTENT_PAGES; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    page_ids.push_back(page_id);
+  }
+  page_ids.insert(page_ids.end(), extent_pages.begin(), extent_pages.end());
+  std::sort(page_ids.begin(), page_ids.end());
+  EXPECT_EQ(page_ids.end(), std::adjacent_find(page_ids.begin(), page_ids.end()));
+  for (page_id_t page_id = 0; page_id < extent_pages[0]; page_id++) {
+    EXPECT_TRUE(std::binary_search(page_ids.begin(), page_ids.end(), page_id));
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,40 @@
+/**
+ * read_ahead_test.cpp
+ */
+
+#include "buffer/read_ahead.h"
+
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ReadAheadWindowTest, SampleTest) {
+  ReadAheadWindow read_ahead;
+  EXPECT_EQ(0, read_ahead.GetWindow());
+
+  // Scenario: the first move to another page starts a small read-ahead, and the next one asks for nothing.
+  EXPECT_EQ(READ_AHEAD_MIN_PAGES, read_ahead.Advance());
+  EXPECT_EQ(0, read_ahead.Advance());
+
+  // Scenario: once half of the window is consumed the window doubles, until it reaches its maximum.
+  std::vector<size_t> windows;
+  for (int page = 0; page < 200; page++) {
+    if (auto count = read_ahead.Advance(); count > 0) {
+      windows.push_back(count);
+    }
+  }
+  ASSERT_GE(windows.size(), 4);
+  EXPECT_EQ(READ_AHEAD_MIN_PAGES * 2, windows[0]);
+  EXPECT_EQ(READ_AHEAD_MIN_PAGES * 4, windows[1]);
+  for (size_t i = 1; i < windows.size(); i++) {
+    EXPECT_LE(windows[i], READ_AHEAD_MAX_PAGES);
+    EXPECT_GE(windows[i], windows[i - 1]);
+  }
+  EXPECT_EQ(READ_AHEAD_MAX_PAGES, windows.back());
+  EXPECT_EQ(READ_AHEAD_MAX_PAGES, read_ahead.GetWindow());
+}
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
+#include <future>  // NOLINT
 #include <random>
 #include <thread>  // NOLINT
 
@@ -603,4 +604,52 @@ TEST(BPlusTreeConcurrentTest, MixTest4) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, OptimisticWriteTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 8, 8);
+  GenericKey<8> index_key;
+  RID rid;
+  for (int64_t key = 0; key < 40; key += 2) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, key);
+    ASSERT_TRUE(tree.Insert(index_key, rid));
+  }
+
+  // Scenario: with the header page read latched, a writer that had to latch down from the header would block. Inserts
+  // and removes that neither split nor merge their leaf only latch the leaf, so they go through.
+  auto insert_and_remove = std::async(std::launch::async, [&tree] {
+    GenericKey<8> key;
+    RID value;
+    key.SetFromInteger(1);
+    value.Set(0, 1);
+    bool inserted = tree.Insert(key, value);
+    bool duplicate = tree.Insert(key, value);
+    tree.Remove(key, nullptr);
+    return inserted && !duplicate;
+  });
+  {
+    auto header_guard = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(std::future_status::ready, insert_and_remove.wait_for(std::chrono::seconds(5)));
+  }
+  EXPECT_TRUE(insert_and_remove.get());
+
+  // Scenario: once a leaf is full, inserts into it fall back to the latched path and split it.
+  for (int64_t key = 1; key < 40; key += 2) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, key);
+    ASSERT_TRUE(tree.Insert(index_key, rid));
+  }
+  int64_t expected = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ(expected++, (*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(40, expected);
+}
+
 }  // namespace bustub
@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager_memory.h"
@@ -181,4 +185,52 @@ TEST(BPlusTreeTests, InsertTest3) {
   delete transaction;
   delete bpm;
 }
+TEST(BPlusTreeTests, InsertWaitsForFrameTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(10, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 2, 3);
+  GenericKey<8> index_key;
+  RID rid;
+  for (int64_t key = 1; key <= 2; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF));
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid));
+  }
+
+  // Scenario: every frame is pinned for a while, as it can be by other threads' descents. An insert that has to
+  // split the leaf waits for a frame instead of failing halfway.
+  std::vector<page_id_t> pinned;
+  while (bpm->NewPage(&page_id) != nullptr) {
+    pinned.push_back(page_id);
+  }
+  std::thread releaser([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (auto pinned_page_id : pinned) {
+      bpm->UnpinPage(pinned_page_id, false);
+    }
+  });
+  rid.Set(0, 3);
+  index_key.SetFromInteger(3);
+  EXPECT_TRUE(tree.Insert(index_key, rid));
+  releaser.join();
+
+  std::vector<RID> result;
+  for (int64_t key = 1; key <= 3; key++) {
+    result.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &result));
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(key, result[0].GetSlotNum());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 }  // namespace bustub
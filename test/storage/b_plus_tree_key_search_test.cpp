@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/page/b_plus_tree_key_search.h"
+
+namespace bustub {
+
+namespace {
+
+/** Check KeyLowerBound against std::lower_bound/upper_bound over memcmp for sorted keys of the given width. */
+template <size_t Width>
+void CheckKeyLowerBound(uint64_t seed, KeySearchIsa isa) {
+  using Key = std::array<char, Width>;
+  std::mt19937_64 rng(seed);
+  for (int round = 0; round < 200; round++) {
+    int count = static_cast<int>(rng() % 300);
+    // A small value range gives runs of equal keys.
+    uint64_t range = round % 2 == 0 ? 64 : UINT64_MAX;
+    std::vector<Key> keys(count);
+    for (auto &key : keys) {
+      uint64_t bits = range == UINT64_MAX ? rng() : rng() % range;
+      for (size_t i = 0; i < Width; i++) {
+        key[i] = static_cast<char>(bits >> (8 * (Width - 1 - i)));
+      }
+    }
+    auto less = [](const Key &a, const Key &b) { return memcmp(a.data(), b.data(), Width) < 0; };
+    std::sort(keys.begin(), keys.end(), less);
+
+    for (int probe = 0; probe < 50; probe++) {
+      Key target;
+      if (count > 0 && probe % 2 == 0) {
+        target = keys[rng() % count];
+      } else {
+        for (auto &byte : target) {
+          byte = static_cast<char>(rng());
+        }
+      }
+      if (probe == 1) {
+        target.fill(0);
+      } else if (probe == 3) {
+        target.fill(static_cast<char>(0xFF));
+      }
+      auto lower = std::lower_bound(keys.begin(), keys.end(), target, less) - keys.begin();
+      auto upper = std::upper_bound(keys.begin(), keys.end(), target, less) - keys.begin();
+      const char *data = reinterpret_cast<const char *>(keys.data());
+      ASSERT_EQ(KeyLowerBound(data, count, Width, target.data(), false, isa), lower);
+      ASSERT_EQ(KeyLowerBound(data, count, Width, target.data(), true, isa), upper);
+    }
+  }
+}
+
+}  // namespace
+
+// Run every instruction set this CPU supports.
+TEST(BPlusTreeKeySearchTest, LowerBound32Test) {
+  for (auto isa : {KeySearchIsa::SCALAR, KeySearchIsa::SSE42, KeySearchIsa::AVX2}) {
+    if (isa <= GetKeySearchIsa()) {
+      CheckKeyLowerBound<4>(4, isa);
+    }
+  }
+}
+
+TEST(BPlusTreeKeySearchTest, LowerBound64Test) {
+  for (auto isa : {KeySearchIsa::SCALAR, KeySearchIsa::SSE42, KeySearchIsa::AVX2}) {
+    if (isa <= GetKeySearchIsa()) {
+      CheckKeyLowerBound<8>(8, isa);
+    }
+  }
+}
+
+TEST(BPlusTreeKeySearchTest, SimdKeyTypesTest) {
+  // Only keys that fit a lane and compare with memcmp take the vector search.
+  EXPECT_TRUE((SIMD_KEY_SEARCH<GenericKey<4>, GenericComparator<4>>));
+  EXPECT_TRUE((SIMD_KEY_SEARCH<GenericKey<8>, GenericComparator<8>>));
+  EXPECT_FALSE((SIMD_KEY_SEARCH<GenericKey<16>, GenericComparator<16>>));
+}
+
+}  // namespace bustub
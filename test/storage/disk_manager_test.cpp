@@ -10,11 +10,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
 #include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/compressed_disk_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/page_codec.h"
 
 namespace bustub {
 
@@ -55,6 +64,353 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LargeOffsetTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // Scenario: a page that starts beyond 2 GiB round-trips (the file is sparse, so this takes no space).
+  const page_id_t far_page = (1 << 19) + 7;
+  dm.WritePage(far_page, data);
+  dm.ReadPage(far_page, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  // Scenario: pages in the hole and past the end of the file read as zeros.
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(far_page - 1, buf);
+  EXPECT_EQ(0, buf[0]);
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(far_page + 1, buf);
+  EXPECT_EQ(0, buf[BUSTUB_PAGE_SIZE - 1]);
+
+  // Scenario: the page went to its own segment file, not to a hole in the database file.
+  const std::string segment_file = db_file + "." + std::to_string(far_page / SEGMENT_FILE_PAGES);
+  EXPECT_TRUE(std::filesystem::exists(segment_file));
+  EXPECT_LT(std::filesystem::file_size(db_file), static_cast<uintmax_t>(SEGMENT_FILE_PAGES) * BUSTUB_PAGE_SIZE);
+
+  dm.ShutDown();
+  remove(segment_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, SegmentFilesTest) {
+  const size_t num_pages = 4;
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<const char *> pages_data;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::memset(pages[i].data(), static_cast<int>('a' + i), BUSTUB_PAGE_SIZE);
+    pages_data.push_back(pages[i].data());
+  }
+  auto remove_files = [] {
+    remove("segments.db");
+    remove("segments.db.1");
+    remove("segments.log");
+  };
+  remove_files();
+  std::string db_file("segments.db");
+  const page_id_t first_page = SEGMENT_FILE_PAGES - 2;
+
+  {
+    auto dm = DiskManager(db_file);
+    // Scenario: a run that crosses the end of segment 0 is split between the database file and segment 1.
+    dm.WritePages(first_page, pages_data);
+    EXPECT_EQ(num_pages, dm.GetNumWrites());
+    EXPECT_TRUE(std::filesystem::exists("segments.db.1"));
+    EXPECT_EQ(static_cast<uintmax_t>(SEGMENT_FILE_PAGES) * BUSTUB_PAGE_SIZE, std::filesystem::file_size(db_file));
+    EXPECT_EQ(2 * BUSTUB_PAGE_SIZE, std::filesystem::file_size("segments.db.1"));
+    dm.ShutDown();
+  }
+
+  // Scenario: after reopening, the segment files are found again, by single and by batched reads.
+  auto dm = DiskManager(db_file);
+  for (size_t i = 0; i < num_pages; i++) {
+    dm.ReadPage(first_page + static_cast<page_id_t>(i), buf);
+    EXPECT_EQ(std::memcmp(buf, pages[i].data(), sizeof(buf)), 0);
+  }
+  std::vector<std::vector<char>> read(num_pages + 1, std::vector<char>(BUSTUB_PAGE_SIZE, 1));
+  std::vector<char *> read_data;
+  for (auto &page : read) {
+    read_data.push_back(page.data());
+  }
+  dm.ReadPages(first_page, read_data);
+  for (size_t i = 0; i < num_pages; i++) {
+    EXPECT_EQ(read[i], pages[i]);
+  }
+  EXPECT_EQ(0, read[num_pages][0]);
+
+  // Scenario: a page of a segment that was never written reads as zeros without creating the file.
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(2 * SEGMENT_FILE_PAGES, buf);
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_FALSE(std::filesystem::exists("segments.db.2"));
+
+  dm.ShutDown();
+  remove_files();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WritePagesTest) {
+  const size_t num_pages = 5;
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<const char *> pages_data;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::memset(pages[i].data(), static_cast<int>('a' + i), BUSTUB_PAGE_SIZE);
+    pages_data.push_back(pages[i].data());
+  }
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  // Scenario: a run of pages written in one call lands at consecutive page offsets.
+  dm.WritePages(3, pages_data);
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+  for (size_t i = 0; i < num_pages; i++) {
+    dm.ReadPage(static_cast<page_id_t>(3 + i), buf);
+    EXPECT_EQ(std::memcmp(buf, pages[i].data(), sizeof(buf)), 0);
+  }
+
+  // Scenario: the pages before the run read as zeros, and an empty run writes nothing.
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(2, buf);
+  EXPECT_EQ(0, buf[0]);
+  dm.WritePages(0, {});
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ReadPagesTest) {
+  const size_t num_pages = 4;
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<char *> pages_data;
+  for (auto &page : pages) {
+    pages_data.push_back(page.data());
+  }
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  for (size_t i = 0; i < num_pages; i++) {
+    std::memset(buf, static_cast<int>('a' + i), sizeof(buf));
+    dm.WritePage(static_cast<page_id_t>(i), buf);
+  }
+
+  // Scenario: a run of pages read in one call comes from consecutive page offsets.
+  dm.ReadPages(1, {pages_data[0], pages_data[1], pages_data[2]});
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_EQ('a' + static_cast<int>(i) + 1, pages[i][0]);
+    EXPECT_EQ('a' + static_cast<int>(i) + 1, pages[i][BUSTUB_PAGE_SIZE - 1]);
+  }
+
+  // Scenario: the pages past the end of the file read as zeros.
+  for (auto &page : pages) {
+    std::memset(page.data(), 1, BUSTUB_PAGE_SIZE);
+  }
+  dm.ReadPages(3, pages_data);
+  EXPECT_EQ('d', pages[0][0]);
+  for (size_t i = 1; i < num_pages; i++) {
+    EXPECT_EQ(0, pages[i][0]);
+    EXPECT_EQ(0, pages[i][BUSTUB_PAGE_SIZE - 1]);
+  }
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIoTest) {
+  alignas(BUSTUB_PAGE_SIZE) char aligned[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE + 1] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, true);
+  std::strncpy(data + 1, "A test string.", BUSTUB_PAGE_SIZE);
+
+  // Scenario: direct I/O (or buffered I/O where the file system lacks it) works with aligned and unaligned buffers.
+  dm.WritePage(0, data + 1);
+  dm.ReadPage(0, aligned);
+  EXPECT_EQ(std::memcmp(aligned, data + 1, BUSTUB_PAGE_SIZE), 0);
+  dm.WritePage(1, aligned);
+  std::memset(data, 0, sizeof(data));
+  dm.ReadPage(1, data + 1);
+  EXPECT_EQ(std::memcmp(aligned, data + 1, BUSTUB_PAGE_SIZE), 0);
+  dm.Sync();
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, UnlimitedMemoryTest) {
+  const int num_threads = 4;
+  const int pages_per_thread = 200;
+  DiskManagerUnlimitedMemory dm;
+  EXPECT_FALSE(dm.IsDirectIo());
+
+  // Scenario: threads write and read back pages spread over many chunks, including the largest page id.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&dm, t] {
+      char buf[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = (i * num_threads + t) * 4099;
+        std::memset(buf, 0, sizeof(buf));
+        snprintf(buf, sizeof(buf), "page %d", page_id);
+        dm.WritePage(page_id, buf);
+      }
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = (i * num_threads + t) * 4099;
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::strncpy(buf, "last page", sizeof(buf));
+  dm.WritePage(std::numeric_limits<page_id_t>::max(), buf);
+  std::memset(buf, 0, sizeof(buf));
+  dm.ReadPage(std::numeric_limits<page_id_t>::max(), buf);
+  EXPECT_EQ(std::string("last page"), std::string(buf));
+
+  // Scenario: with a queue depth of one, concurrent requests are served one after the other.
+  DiskLatencyModel model;
+  model.latency_ = std::chrono::milliseconds(5);
+  model.queue_depth_ = 1;
+  dm.SetLatencyModel(model);
+  auto start = std::chrono::steady_clock::now();
+  threads.clear();
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&dm] {
+      char page[BUSTUB_PAGE_SIZE];
+      dm.ReadPage(0, page);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_GE(std::chrono::steady_clock::now() - start, num_threads * model.latency_);
+
+  // Scenario: a vectored write of n pages is one request, but its transfer is bounded by the bandwidth.
+  model.latency_ = std::chrono::microseconds(0);
+  model.queue_depth_ = 0;
+  model.bandwidth_ = 1 << 20;
+  dm.SetLatencyModel(model);
+  std::vector<const char *> pages_data(16, buf);
+  start = std::chrono::steady_clock::now();
+  dm.WritePages(1, pages_data);
+  const auto transfer = std::chrono::microseconds(pages_data.size() * BUSTUB_PAGE_SIZE * 1000000 / model.bandwidth_);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, transfer);
+  dm.SetLatency(0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PageCodecTest) {
+  std::mt19937 gen(15445);
+  std::vector<std::vector<char>> pages;
+  pages.emplace_back(BUSTUB_PAGE_SIZE, 0);
+  // Small integers in a mostly empty page, like a table page.
+  pages.emplace_back(BUSTUB_PAGE_SIZE, 0);
+  for (size_t i = 0; i < BUSTUB_PAGE_SIZE / 2; i += 8) {
+    pages.back()[i] = static_cast<char>(i / 8 % 100);
+  }
+  pages.emplace_back(BUSTUB_PAGE_SIZE);
+  for (auto &c : pages.back()) {
+    c = static_cast<char>(gen());
+  }
+
+  char compressed[BUSTUB_PAGE_SIZE * 2];
+  char page[BUSTUB_PAGE_SIZE];
+  for (const auto &data : pages) {
+    size_t size = PageCodec::Compress(data.data(), compressed, sizeof(compressed));
+    ASSERT_GT(size, 0);
+    ASSERT_TRUE(PageCodec::Decompress(compressed, size, page));
+    EXPECT_EQ(std::memcmp(page, data.data(), BUSTUB_PAGE_SIZE), 0);
+    // Truncated input is rejected rather than read past its end.
+    EXPECT_FALSE(PageCodec::Decompress(compressed, size - 1, page));
+  }
+  EXPECT_LT(PageCodec::Compress(pages[0].data(), compressed, sizeof(compressed)), BUSTUB_PAGE_SIZE / 64);
+  EXPECT_LT(PageCodec::Compress(pages[1].data(), compressed, sizeof(compressed)), BUSTUB_PAGE_SIZE / 2);
+  // Random bytes don't compress, and compression gives up once the output is full.
+  EXPECT_EQ(PageCodec::Compress(pages[2].data(), compressed, BUSTUB_PAGE_SIZE), 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompressedTest) {
+  // A file of its own, as ctest may run the other tests of this suite at the same time.
+  auto remove_files = [] {
+    remove("compressed.db");
+    remove("compressed.db.map");
+    remove("compressed.log");
+  };
+  remove_files();
+  const size_t num_pages = 64;
+  std::mt19937 gen(15445);
+  auto make_page = [&](size_t i, bool random) {
+    std::vector<char> data(BUSTUB_PAGE_SIZE, 0);
+    for (size_t j = 0; j < (random ? BUSTUB_PAGE_SIZE : 512); j++) {
+      data[j] = random ? static_cast<char>(gen()) : static_cast<char>((i + j) % 7);
+    }
+    return data;
+  };
+  std::vector<std::vector<char>> pages;
+  for (size_t i = 0; i < num_pages; i++) {
+    pages.push_back(make_page(i, i % 8 == 0));
+  }
+
+  char buf[BUSTUB_PAGE_SIZE];
+  {
+    CompressedDiskManager dm("compressed.db");
+    dm.ReadPage(3, buf);  // never written: zeros
+    EXPECT_EQ(buf[0], 0);
+    std::vector<const char *> data;
+    for (const auto &page : pages) {
+      data.push_back(page.data());
+    }
+    dm.WritePages(0, data);
+    EXPECT_EQ(dm.GetNumStoredPages(), num_pages);
+    EXPECT_LT(dm.GetStoredBytes(), num_pages * BUSTUB_PAGE_SIZE / 2);
+
+    // Rewrites change the size class of the page; the old slot is reused after a sync.
+    pages[1] = make_page(1, true);
+    dm.WritePage(1, pages[1].data());
+    pages[8] = make_page(8, false);
+    dm.WritePage(8, pages[8].data());
+    dm.Sync();
+    pages[1] = make_page(101, false);
+    dm.WritePage(1, pages[1].data());
+    for (size_t i = 0; i < num_pages; i++) {
+      dm.ReadPage(static_cast<page_id_t>(i), buf);
+      EXPECT_EQ(std::memcmp(buf, pages[i].data(), BUSTUB_PAGE_SIZE), 0) << i;
+    }
+    dm.ShutDown();
+  }
+
+  // The page map survives a restart.
+  CompressedDiskManager dm("compressed.db");
+  EXPECT_EQ(dm.GetNumStoredPages(), num_pages);
+  std::vector<std::vector<char>> read(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<char *> read_data;
+  for (auto &page : read) {
+    read_data.push_back(page.data());
+  }
+  dm.ReadPages(0, read_data);
+  for (size_t i = 0; i < num_pages; i++) {
+    EXPECT_EQ(read[i], pages[i]) << i;
+  }
+  // Pages written after the restart go into the free space between the slots, not past the end of the file.
+  auto file_size = std::filesystem::file_size("compressed.db");
+  for (size_t i = 0; i < 4; i++) {
+    dm.WritePage(static_cast<page_id_t>(num_pages + i), make_page(i, false).data());
+  }
+  EXPECT_EQ(std::filesystem::file_size("compressed.db"), file_size);
+  dm.ShutDown();
+  remove_files();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleWriteReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+
+  // Requests may run concurrently, so the read is only scheduled once the write is done.
+  disk_scheduler->Schedule({/*is_write=*/true, data, /*page_id=*/0, std::move(promise1)});
+  ASSERT_TRUE(future1.get());
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/0, std::move(promise2)});
+  ASSERT_TRUE(future2.get());
+
+  ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  disk_scheduler = nullptr;  // Call the DiskScheduler destructor to finish all scheduled jobs.
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ParallelRequestsTest) {
+  const size_t num_workers = 4;
+  const size_t num_requests = 8;
+  const size_t latency_ms = 100;
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), num_workers);
+  dm->SetLatency(latency_ms);
+
+  // Scenario: with four workers, eight slow writes finish in about two rounds of latency, and every completion
+  // hook runs before its future is ready.
+  std::vector<std::vector<char>> pages(num_requests, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> futures;
+  std::atomic<size_t> completed{0};
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_requests; i++) {
+    snprintf(pages[i].data(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    auto promise = disk_scheduler->CreatePromise();
+    futures.push_back(promise.get_future());
+    disk_scheduler->Schedule(
+        {/*is_write=*/true, pages[i].data(), static_cast<page_id_t>(i), std::move(promise), [&] { completed++; }});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  EXPECT_EQ(num_requests, completed);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(latency_ms * num_requests / 2));
+
+  dm->SetLatency(0);
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  for (size_t i = 0; i < num_requests; i++) {
+    auto promise = disk_scheduler->CreatePromise();
+    auto future = promise.get_future();
+    disk_scheduler->Schedule({/*is_write=*/false, buf, static_cast<page_id_t>(i), std::move(promise)});
+    ASSERT_TRUE(future.get());
+    EXPECT_STREQ(pages[i].data(), buf);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,152 @@
+/**
+ * free_page_list_test.cpp
+ */
+
+#include "storage/disk/free_page_list.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+TEST(FreePageListTest, SampleTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  FreePageList free_pages(disk_manager.get());
+  page_id_t page_id;
+
+  // Scenario: an empty list hands out nothing.
+  EXPECT_FALSE(free_pages.Pop(&page_id));
+  EXPECT_EQ(INVALID_PAGE_ID, free_pages.GetHeadPageId());
+
+  // Scenario: pages come back in LIFO order; the first one is the trunk and comes back last.
+  for (page_id_t i = 0; i < 5; i++) {
+    free_pages.Push(i);
+  }
+  EXPECT_EQ(5, free_pages.Size());
+  EXPECT_EQ(0, free_pages.GetHeadPageId());
+  for (page_id_t i = 4; i >= 0; i--) {
+    ASSERT_TRUE(free_pages.Pop(&page_id));
+    EXPECT_EQ(i, page_id);
+  }
+  EXPECT_FALSE(free_pages.Pop(&page_id));
+  EXPECT_EQ(0, free_pages.Size());
+}
+
+TEST(FreePageListTest, TrunkChainTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  FreePageList free_pages(disk_manager.get());
+
+  // Scenario: more free pages than one trunk can list spill into a chain of trunks, and every page is handed out
+  // exactly once. None of them has been written, so Pop() never has to wait for a read.
+  const auto num_pages = static_cast<page_id_t>(FreeListTrunkPage::CAPACITY * 3 + 10);
+  for (page_id_t i = 0; i < num_pages; i++) {
+    EXPECT_TRUE(free_pages.Push(i));
+  }
+  // Pushing a page that is on the list already, in the head trunk or further down the chain, does nothing.
+  EXPECT_FALSE(free_pages.Push(num_pages - 1));
+  EXPECT_FALSE(free_pages.Push(0));
+  EXPECT_EQ(num_pages, free_pages.Size());
+  std::vector<page_id_t> popped;
+  page_id_t page_id;
+  while (free_pages.Pop(&page_id)) {
+    popped.push_back(page_id);
+  }
+  ASSERT_EQ(num_pages, popped.size());
+  std::sort(popped.begin(), popped.end());
+  for (page_id_t i = 0; i < num_pages; i++) {
+    EXPECT_EQ(i, popped[i]);
+  }
+}
+
+TEST(FreePageListTest, ReopenTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  const auto num_pages = static_cast<page_id_t>(FreeListTrunkPage::CAPACITY * 2 + 10);
+  page_id_t head_page_id;
+  {
+    FreePageList free_pages(disk_manager.get());
+    for (page_id_t i = 0; i < num_pages; i++) {
+      EXPECT_TRUE(free_pages.Push(i));
+    }
+    free_pages.Flush();
+    head_page_id = free_pages.GetHeadPageId();
+  }
+
+  // Scenario: a list reopened from its head trunk has every page that was on it.
+  FreePageList free_pages(disk_manager.get());
+  ASSERT_TRUE(free_pages.Open(head_page_id, num_pages));
+  EXPECT_EQ(num_pages, free_pages.Size());
+  EXPECT_TRUE(free_pages.Contains(0));
+  EXPECT_FALSE(free_pages.Push(num_pages - 1));
+
+  // Scenario: once Pop() reaches a trunk that is only on disk it fails until the trunk is loaded, and asks for the
+  // read only once.
+  std::vector<page_id_t> popped;
+  page_id_t page_id;
+  int reads = 0;
+  while (free_pages.Size() > 0) {
+    if (free_pages.Pop(&page_id)) {
+      popped.push_back(page_id);
+      continue;
+    }
+    page_id_t trunk_page_id = free_pages.StartHeadRead();
+    ASSERT_NE(INVALID_PAGE_ID, trunk_page_id);
+    EXPECT_EQ(INVALID_PAGE_ID, free_pages.StartHeadRead());
+    char data[BUSTUB_PAGE_SIZE];
+    disk_manager->ReadPage(trunk_page_id, data);
+    free_pages.LoadHead(trunk_page_id, data);
+    reads++;
+  }
+  EXPECT_EQ(2, reads);
+  ASSERT_EQ(num_pages, popped.size());
+  std::sort(popped.begin(), popped.end());
+  for (page_id_t i = 0; i < num_pages; i++) {
+    EXPECT_EQ(i, popped[i]);
+  }
+
+  // Scenario: a damaged chain is not reopened.
+  FreePageList damaged(disk_manager.get());
+  EXPECT_FALSE(damaged.Open(head_page_id, head_page_id));
+  EXPECT_EQ(0, damaged.Size());
+  EXPECT_FALSE(damaged.Pop(&page_id));
+}
+
+TEST(FreePageListTest, PushOverUnloadedHeadTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  FreePageList free_pages(disk_manager.get());
+  const auto num_pages = static_cast<page_id_t>(FreeListTrunkPage::CAPACITY + 2);
+  for (page_id_t i = 0; i < num_pages; i++) {
+    free_pages.Push(i);
+  }
+  free_pages.Flush();
+  page_id_t page_id;
+  // The head trunk lists nothing, so it is handed out itself; the next trunk is only on disk.
+  ASSERT_TRUE(free_pages.Pop(&page_id));
+  EXPECT_EQ(num_pages - 1, page_id);
+  EXPECT_FALSE(free_pages.Pop(&page_id));
+  page_id_t trunk_page_id = free_pages.StartHeadRead();
+  ASSERT_EQ(0, trunk_page_id);
+
+  // Scenario: a page freed meanwhile becomes a new head in front of the unloaded trunk, and the late read of that
+  // trunk is ignored until the list gets back to it.
+  ASSERT_TRUE(free_pages.Push(num_pages));
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(trunk_page_id, data);
+  free_pages.LoadHead(trunk_page_id, data);
+  ASSERT_TRUE(free_pages.Pop(&page_id));
+  EXPECT_EQ(num_pages, page_id);
+  EXPECT_FALSE(free_pages.Pop(&page_id));
+  ASSERT_EQ(trunk_page_id, free_pages.StartHeadRead());
+  free_pages.LoadHead(trunk_page_id, data);
+  size_t popped = 0;
+  while (free_pages.Pop(&page_id)) {
+    popped++;
+  }
+  EXPECT_EQ(FreeListTrunkPage::CAPACITY + 1, popped);
+  EXPECT_EQ(0, free_pages.Size());
+}
+
+}  // namespace bustub
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeKey(const Schema &schema, const std::vector<Value> &values, uint64_t descending = 0) -> GenericKey<16> {
+  GenericKey<16> key;
+  key.SetFromKey(Tuple(values, &schema), schema, descending);
+  return key;
+}
+
+}  // namespace
+
+// Keys compare by memcmp in the order of their column values.
+TEST(GenericKeyTest, NormalizedOrderTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT)});
+  GenericComparator<16> comparator(&schema);
+  std::vector<int64_t> numbers = {INT32_MIN + 1, -70000, -1, 0, 1, 255, 256, 70000, INT32_MAX};
+
+  for (auto a : numbers) {
+    for (auto b : numbers) {
+      auto lhs = MakeKey(schema, {ValueFactory::GetIntegerValue(a), ValueFactory::GetBigIntValue(b)});
+      for (auto c : numbers) {
+        auto rhs = MakeKey(schema, {ValueFactory::GetIntegerValue(c), ValueFactory::GetBigIntValue(-b)});
+        int expected = a != c ? (a < c ? -1 : 1) : (b < -b ? -1 : (b > -b ? 1 : 0));
+        ASSERT_EQ(comparator(lhs, rhs), expected) << a << " " << b << " " << c;
+      }
+    }
+  }
+
+  // NULL sorts before every value.
+  auto null_key = MakeKey(schema, {ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetBigIntValue(0)});
+  auto min_key = MakeKey(schema, {ValueFactory::GetIntegerValue(INT32_MIN + 1), ValueFactory::GetBigIntValue(0)});
+  EXPECT_LT(comparator(null_key, min_key), 0);
+}
+
+TEST(GenericKeyTest, DecimalAndDescendingTest) {
+  Schema schema({Column("a", TypeId::DECIMAL), Column("b", TypeId::SMALLINT)});
+  GenericComparator<16> comparator(&schema);
+  std::vector<double> numbers = {-1e300, -2.5, -1, -0.0, 0, 1e-300, 1, 2.5, 1e300};
+
+  for (auto a : numbers) {
+    for (auto c : numbers) {
+      // The second column is descending.
+      auto lhs = MakeKey(schema, {ValueFactory::GetDecimalValue(a), ValueFactory::GetSmallIntValue(1)}, 0b10);
+      auto rhs = MakeKey(schema, {ValueFactory::GetDecimalValue(c), ValueFactory::GetSmallIntValue(2)}, 0b10);
+      int expected = a != c ? (a < c ? -1 : 1) : 1;
+      ASSERT_EQ(comparator(lhs, rhs), expected) << a << " " << c;
+    }
+  }
+}
+
+TEST(GenericKeyTest, VarcharTest) {
+  Schema schema({Column("a", TypeId::VARCHAR, 8), Column("b", TypeId::INTEGER)});
+  GenericComparator<16> comparator(&schema);
+  std::vector<std::string> strings = {"", std::string("\0", 1), std::string("a\0", 2), "a", "ab", "b", "ba"};
+  std::sort(strings.begin(), strings.end());
+
+  for (size_t i = 0; i < strings.size(); i++) {
+    for (size_t j = 0; j < strings.size(); j++) {
+      auto lhs = MakeKey(schema, {ValueFactory::GetVarcharValue(strings[i]), ValueFactory::GetIntegerValue(2)});
+      auto rhs = MakeKey(schema, {ValueFactory::GetVarcharValue(strings[j]), ValueFactory::GetIntegerValue(1)});
+      int expected = i != j ? (i < j ? -1 : 1) : 1;
+      ASSERT_EQ(comparator(lhs, rhs), expected) << i << " " << j;
+    }
+  }
+
+  auto null_key =
+      MakeKey(schema, {ValueFactory::GetNullValueByType(TypeId::VARCHAR), ValueFactory::GetIntegerValue(1)});
+  auto empty_key = MakeKey(schema, {ValueFactory::GetVarcharValue(""), ValueFactory::GetIntegerValue(0)});
+  EXPECT_LT(comparator(null_key, empty_key), 0);
+
+  // Keys longer than the key size are truncated and compare by their prefix.
+  auto long1 = MakeKey(schema, {ValueFactory::GetVarcharValue("abcdefghijklmnopq"), ValueFactory::GetIntegerValue(1)});
+  auto long2 = MakeKey(schema, {ValueFactory::GetVarcharValue("abcdefghijklmnopr"), ValueFactory::GetIntegerValue(1)});
+  EXPECT_EQ(comparator(long1, long2), 0);
+}
+
+TEST(GenericKeyTest, IntegerRoundTripTest) {
+  GenericComparator<8> comparator(nullptr);
+  std::vector<int64_t> numbers = {INT64_MIN, -256, -1, 0, 1, 42, INT64_MAX};
+  for (size_t i = 0; i < numbers.size(); i++) {
+    GenericKey<8> key;
+    key.SetFromInteger(numbers[i]);
+    EXPECT_EQ(key.ToString(), numbers[i]);
+    if (i > 0) {
+      GenericKey<8> prev;
+      prev.SetFromInteger(numbers[i - 1]);
+      EXPECT_LT(comparator(prev, key), 0);
+    }
+  }
+}
+
+}  // namespace bustub
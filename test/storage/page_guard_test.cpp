@@ -48,4 +48,46 @@ TEST(PageGuardTest, SampleTest) {
   disk_manager->ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST(PageGuardTest, OptimisticTest) {
+  const size_t buffer_pool_size = 5;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_shared<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+  bpm->UnpinPage(page_id_temp, false);
+
+  // Scenario: an optimistic guard pins the page without latching it, so writers are not blocked.
+  {
+    auto guard = bpm->FetchPageOptimistic(page_id_temp);
+    EXPECT_EQ(1, page0->GetPinCount());
+    EXPECT_EQ(page0->GetData(), guard.GetData());
+    EXPECT_TRUE(guard.Validate());
+    EXPECT_TRUE(guard.Validate());
+
+    auto write_guard = bpm->FetchPageWrite(page_id_temp);
+    EXPECT_FALSE(guard.Validate());
+    write_guard.Drop();
+    EXPECT_FALSE(guard.Validate());
+    EXPECT_FALSE(guard.TryUpgradeRead().has_value());
+  }
+  EXPECT_EQ(0, page0->GetPinCount());
+
+  // Scenario: an unchanged page upgrades to a read latch, handing the pin over to the ReadPageGuard.
+  {
+    auto guard = bpm->FetchPageOptimistic(page_id_temp);
+    auto read_guard = guard.TryUpgradeRead();
+    ASSERT_TRUE(read_guard.has_value());
+    EXPECT_EQ(1, page0->GetPinCount());
+    guard.Drop();
+    EXPECT_EQ(1, page0->GetPinCount());
+  }
+  EXPECT_EQ(0, page0->GetPinCount());
+
+  disk_manager->ShutDown();
+}
+
 }  // namespace bustub
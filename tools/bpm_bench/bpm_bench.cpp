@@ -1,4 +1,6 @@
+#include <array>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -14,6 +16,7 @@
 #include "binder/binder.h"
 #include "buffer/buffer_pool_manager.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
@@ -35,37 +38,134 @@ static const size_t LRU_K_SIZE = 16;
 static const size_t BUSTUB_PAGE_CNT = 6400;
 static const size_t BUSTUB_BPM_SIZE = 64;
 
+/**
+ * FetchPage() latencies of one thread. Buckets are log-linear: every power of two of nanoseconds is split into 16
+ * steps, so a percentile is accurate to about 6%, which the power-of-two buckets of the buffer pool metrics are not.
+ */
+struct FetchLatency {
+  static constexpr size_t SUB_BUCKETS = 16;
+  std::array<uint64_t, 64 * SUB_BUCKETS> counts_{};
+  uint64_t count_{0};
+  uint64_t max_ns_{0};
+
+  static auto BucketOf(uint64_t ns) -> size_t {
+    if (ns < SUB_BUCKETS) {
+      return ns;
+    }
+    size_t shift = 63 - __builtin_clzll(ns) - 4;
+    return SUB_BUCKETS + shift * SUB_BUCKETS + ((ns >> shift) - SUB_BUCKETS);
+  }
+
+  /** @return the largest latency that falls into bucket i */
+  static auto UpperBoundOf(size_t i) -> uint64_t {
+    if (i < SUB_BUCKETS) {
+      return i;
+    }
+    size_t shift = (i - SUB_BUCKETS) / SUB_BUCKETS;
+    return ((SUB_BUCKETS + (i - SUB_BUCKETS) % SUB_BUCKETS + 1) << shift) - 1;
+  }
+
+  void Record(std::chrono::steady_clock::duration latency) {
+    auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+    counts_[BucketOf(ns)] += 1;
+    count_ += 1;
+    max_ns_ = std::max(max_ns_, ns);
+  }
+
+  void Merge(const FetchLatency &other) {
+    for (size_t i = 0; i < counts_.size(); i++) {
+      counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    max_ns_ = std::max(max_ns_, other.max_ns_);
+  }
+
+  /** @return an upper bound of the latency at a percentile in [0, 100], in nanoseconds */
+  auto PercentileNs(double percentile) const -> uint64_t {
+    if (count_ == 0) {
+      return 0;
+    }
+    auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100 * static_cast<double>(count_) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        return std::min(UpperBoundOf(i), max_ns_);
+      }
+    }
+    return max_ns_;
+  }
+
+  auto ToJson() const -> std::string {
+    return fmt::format(R"({{"count": {}, "p50_ns": {}, "p99_ns": {}, "p999_ns": {}, "max_ns": {}}})", count_,
+                       PercentileNs(50), PercentileNs(99), PercentileNs(99.9), max_ns_);
+  }
+
+  auto ToString() const -> std::string {
+    return fmt::format("count={} p50={:.1f}us p99={:.1f}us p999={:.1f}us max={:.1f}us", count_,
+                       PercentileNs(50) / 1000.0, PercentileNs(99) / 1000.0, PercentileNs(99.9) / 1000.0,
+                       max_ns_ / 1000.0);
+  }
+};
+
 struct BpmTotalMetrics {
   uint64_t scan_cnt_{0};
   uint64_t get_cnt_{0};
+  FetchLatency scan_latency_;
+  FetchLatency get_latency_;
   uint64_t start_time_{0};
+  uint64_t elapsed_{0};
   std::mutex mutex_;
 
   void Begin() { start_time_ = ClockMs(); }
 
-  void ReportScan(uint64_t scan_cnt) {
+  void End() { elapsed_ = ClockMs() - start_time_; }
+
+  void ReportScan(uint64_t scan_cnt, const FetchLatency &latency) {
     std::unique_lock<std::mutex> l(mutex_);
     scan_cnt_ += scan_cnt;
+    scan_latency_.Merge(latency);
   }
 
-  void ReportGet(uint64_t get_cnt) {
+  void ReportGet(uint64_t get_cnt, const FetchLatency &latency) {
     std::unique_lock<std::mutex> l(mutex_);
     get_cnt_ += get_cnt;
+    get_latency_.Merge(latency);
   }
 
-  void Report() {
-    auto now = ClockMs();
-    auto elsped = now - start_time_;
-    auto scan_per_sec = scan_cnt_ / static_cast<double>(elsped) * 1000;
-    auto get_per_sec = get_cnt_ / static_cast<double>(elsped) * 1000;
+  auto ScanPerSec() const -> double { return scan_cnt_ / static_cast<double>(elapsed_) * 1000; }
+
+  auto GetPerSec() const -> double { return get_cnt_ / static_cast<double>(elapsed_) * 1000; }
 
+  void Report() {
     fmt::print("<<< BEGIN\n");
-    fmt::print("scan: {}\n", scan_per_sec);
-    fmt::print("get: {}\n", get_per_sec);
+    fmt::print("scan: {}\n", ScanPerSec());
+    fmt::print("get: {}\n", GetPerSec());
     fmt::print(">>> END\n");
+    fmt::print(stderr, "[latency] scan fetch: {}\n", scan_latency_.ToString());
+    fmt::print(stderr, "[latency] get fetch: {}\n", get_latency_.ToString());
   }
 };
 
+/** @return value as a JSON number if it is one, otherwise as a JSON string */
+auto JsonValue(const std::string &value) -> std::string {
+  char *end = nullptr;
+  std::strtod(value.c_str(), &end);
+  if (!value.empty() && end == value.c_str() + value.size()) {
+    return value;
+  }
+  return fmt::format("\"{}\"", value);
+}
+
+/** @return metric rows as a JSON object */
+auto RowsToJson(const std::vector<std::pair<std::string, std::string>> &rows) -> std::string {
+  std::string json = "{";
+  for (const auto &[name, value] : rows) {
+    json += fmt::format("{}\"{}\": {}", json.size() > 1 ? ", " : "", name, JsonValue(value));
+  }
+  return json + "}";
+}
+
 struct BpmMetrics {
   uint64_t start_time_{0};
   uint64_t last_report_at_{0};
@@ -106,10 +206,31 @@ auto main(int argc, char **argv) -> int {
   using bustub::BufferPoolManager;
   using bustub::DiskManagerUnlimitedMemory;
   using bustub::page_id_t;
+  using bustub::ParallelBufferPoolManager;
+  using bustub::ReplacerType;
 
   argparse::ArgumentParser program("bustub-bpm-bench");
   program.add_argument("--duration").help("run bpm bench for n milliseconds");
   program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--latency-us").help("set disk latency to n microseconds, overrides --latency");
+  program.add_argument("--queue-depth").help("let the disk serve at most n requests at once");
+  program.add_argument("--bandwidth").help("cap the disk bandwidth at n MB/s");
+  program.add_argument("--shards").help("split the buffer pool into n independent instances");
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool");
+  program.add_argument("--page-cnt").help("number of pages to create and access");
+  program.add_argument("--replacer").help("replacement policy: lru-k (default), lru or clock");
+  program.add_argument("--bg-writer").help("run the background writer, keeping n frames clean");
+  program.add_argument("--workload")
+      .help("mixed (default: scans and zipfian point reads), scan (scan-heavy), point (point reads only) or "
+            "hot-shift (point reads whose hot set moves every --shift-ms)");
+  program.add_argument("--scan-threads").help("number of scan threads, overrides the workload");
+  program.add_argument("--get-threads").help("number of point read threads, overrides the workload");
+  program.add_argument("--zipf-theta").help("skew of the point reads, 0.8 by default");
+  program.add_argument("--shift-ms").help("period of the hot-shift workload in milliseconds, 1000 by default");
+  program.add_argument("--json")
+      .help("print the results as one JSON object on stdout")
+      .default_value(false)
+      .implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -129,14 +250,114 @@ auto main(int argc, char **argv) -> int {
     latency_ms = std::stoi(program.get("--latency"));
   }
 
+  bustub::DiskLatencyModel latency_model;
+  latency_model.latency_ = std::chrono::milliseconds(latency_ms);
+  if (program.present("--latency-us")) {
+    latency_model.latency_ = std::chrono::microseconds(std::stoi(program.get("--latency-us")));
+  }
+  if (program.present("--queue-depth")) {
+    latency_model.queue_depth_ = std::stoi(program.get("--queue-depth"));
+  }
+  if (program.present("--bandwidth")) {
+    latency_model.bandwidth_ = static_cast<size_t>(std::stoi(program.get("--bandwidth"))) << 20;
+  }
+
+  size_t shards = 1;
+  if (program.present("--shards")) {
+    shards = std::stoi(program.get("--shards"));
+  }
+  size_t bpm_size = BUSTUB_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoi(program.get("--bpm-size"));
+  }
+
+  size_t page_cnt = BUSTUB_PAGE_CNT;
+  if (program.present("--page-cnt")) {
+    page_cnt = std::stoi(program.get("--page-cnt"));
+  }
+
+  std::string replacer = "lru-k";
+  if (program.present("--replacer")) {
+    replacer = program.get("--replacer");
+  }
+  ReplacerType replacer_type;
+  if (replacer == "lru-k") {
+    replacer_type = ReplacerType::LRUK;
+  } else if (replacer == "lru") {
+    replacer_type = ReplacerType::LRU;
+  } else if (replacer == "clock") {
+    replacer_type = ReplacerType::Clock;
+  } else {
+    std::cerr << "unknown replacer " << replacer << '\n';
+    return 1;
+  }
+
+  size_t bg_writer = 0;
+  if (program.present("--bg-writer")) {
+    bg_writer = std::stoi(program.get("--bg-writer"));
+  }
+
+  std::string workload = "mixed";
+  if (program.present("--workload")) {
+    workload = program.get("--workload");
+  }
+  size_t scan_threads = BUSTUB_SCAN_THREAD;
+  size_t get_threads = BUSTUB_GET_THREAD;
+  if (workload == "scan") {
+    scan_threads = BUSTUB_SCAN_THREAD + BUSTUB_GET_THREAD / 2;
+    get_threads = BUSTUB_GET_THREAD / 2;
+  } else if (workload == "point" || workload == "hot-shift") {
+    scan_threads = 0;
+    get_threads = BUSTUB_SCAN_THREAD + BUSTUB_GET_THREAD;
+  } else if (workload != "mixed") {
+    std::cerr << "unknown workload " << workload << '\n';
+    return 1;
+  }
+  if (program.present("--scan-threads")) {
+    scan_threads = std::stoi(program.get("--scan-threads"));
+  }
+  if (program.present("--get-threads")) {
+    get_threads = std::stoi(program.get("--get-threads"));
+  }
+
+  double zipf_theta = 0.8;
+  if (program.present("--zipf-theta")) {
+    zipf_theta = std::stod(program.get("--zipf-theta"));
+  }
+  // The hot-shift workload moves the hot set by a quarter of the pages every shift_ms.
+  uint64_t shift_ms = 1000;
+  if (program.present("--shift-ms")) {
+    shift_ms = std::stoi(program.get("--shift-ms"));
+  }
+  if (workload != "hot-shift") {
+    shift_ms = 0;
+  }
+  bool json = program.get<bool>("--json");
+
+  if (shards == 0 || bpm_size % shards != 0) {
+    std::cerr << "--shards must divide the buffer pool size " << bpm_size << '\n';
+    return 1;
+  }
+
   auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  std::unique_ptr<BufferPoolManager> bpm;
+  if (shards == 1) {
+    bpm = std::make_unique<BufferPoolManager>(bpm_size, disk_manager.get(), LRU_K_SIZE, nullptr, replacer_type);
+  } else {
+    bpm = std::make_unique<ParallelBufferPoolManager>(shards, bpm_size / shards, disk_manager.get(), LRU_K_SIZE,
+                                                      nullptr, replacer_type);
+  }
   std::vector<page_id_t> page_ids;
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr,
+             "[info] total_page={}, duration_ms={}, latency_us={}, queue_depth={}, bandwidth={}, lru_k_size={}, "
+             "bpm_size={}, shards={}, replacer={}, bg_writer={}, workload={}, scan_threads={}, get_threads={}, "
+             "zipf_theta={}, shift_ms={}\n",
+             page_cnt, duration_ms, latency_model.latency_.count(), latency_model.queue_depth_,
+             latency_model.bandwidth_, LRU_K_SIZE, bpm_size, shards, replacer, bg_writer, workload, scan_threads,
+             get_threads, zipf_theta, shift_ms);
 
-  for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
+  for (size_t i = 0; i < page_cnt; i++) {
     page_id_t page_id;
     auto *page = bpm->NewPage(&page_id);
     if (page == nullptr) {
@@ -150,7 +371,10 @@ auto main(int argc, char **argv) -> int {
   }
 
   // enable disk latency after creating all pages
-  disk_manager->SetLatency(latency_ms);
+  disk_manager->SetLatencyModel(latency_model);
+  if (bg_writer > 0) {
+    bpm->StartBackgroundWriter(bg_writer, bg_writer);
+  }
 
   fmt::print(stderr, "[info] benchmark start\n");
 
@@ -159,18 +383,21 @@ auto main(int argc, char **argv) -> int {
 
   std::vector<std::thread> threads;
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_SCAN_THREAD; thread_id++) {
-    threads.emplace_back([thread_id, &page_ids, &bpm, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < scan_threads; thread_id++) {
+    threads.emplace_back([thread_id, &page_ids, &bpm, duration_ms, page_cnt, scan_threads, &total_metrics] {
       BpmMetrics metrics(fmt::format("scan {:>2}", thread_id), duration_ms);
+      FetchLatency latency;
       metrics.Begin();
 
-      size_t page_idx = BUSTUB_PAGE_CNT * thread_id / BUSTUB_SCAN_THREAD;
+      size_t page_idx = page_cnt * thread_id / scan_threads;
 
       while (!metrics.ShouldFinish()) {
+        auto start = std::chrono::steady_clock::now();
         auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Scan);
         if (page == nullptr) {
           continue;
         }
+        latency.Record(std::chrono::steady_clock::now() - start);
 
         char &ch = page->GetData()[page_idx % 1024];
         page->WLatch();
@@ -181,30 +408,36 @@ auto main(int argc, char **argv) -> int {
         page->WUnlatch();
 
         bpm->UnpinPage(page->GetPageId(), true, AccessType::Scan);
-        page_idx = (page_idx + 1) % BUSTUB_PAGE_CNT;
+        page_idx = (page_idx + 1) % page_cnt;
         metrics.Tick();
         metrics.Report();
       }
 
-      total_metrics.ReportScan(metrics.cnt_);
+      total_metrics.ReportScan(metrics.cnt_, latency);
     });
   }
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_GET_THREAD; thread_id++) {
-    threads.emplace_back([thread_id, &page_ids, &bpm, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < get_threads; thread_id++) {
+    threads.emplace_back([thread_id, &page_ids, &bpm, duration_ms, page_cnt, zipf_theta, shift_ms, &total_metrics] {
       std::random_device r;
       std::default_random_engine gen(r());
-      zipfian_int_distribution<size_t> dist(0, BUSTUB_PAGE_CNT - 1, 0.8);
+      zipfian_int_distribution<size_t> dist(0, page_cnt - 1, zipf_theta);
 
       BpmMetrics metrics(fmt::format("get  {:>2}", thread_id), duration_ms);
+      FetchLatency latency;
       metrics.Begin();
 
       while (!metrics.ShouldFinish()) {
         auto page_idx = dist(gen);
+        if (shift_ms > 0) {
+          page_idx = (page_idx + (ClockMs() - metrics.start_time_) / shift_ms * (page_cnt / 4)) % page_cnt;
+        }
+        auto start = std::chrono::steady_clock::now();
         auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Get);
         if (page == nullptr) {
           continue;
         }
+        latency.Record(std::chrono::steady_clock::now() - start);
 
         page->RLatch();
         char ch = page->GetData()[page_idx % 1024];
@@ -218,7 +451,7 @@ auto main(int argc, char **argv) -> int {
         metrics.Report();
       }
 
-      total_metrics.ReportGet(metrics.cnt_);
+      total_metrics.ReportGet(metrics.cnt_, latency);
     });
   }
 
@@ -226,7 +459,32 @@ auto main(int argc, char **argv) -> int {
     thread.join();
   }
 
-  total_metrics.Report();
+  total_metrics.End();
+  bpm->StopBackgroundWriter();
+  auto bpm_rows = bpm->GetMetrics().ToRows();
+  auto disk_rows = disk_manager->GetMetrics().ToRows();
+  if (json) {
+    fmt::print(R"({{"config": {{"workload": "{}", "duration_ms": {}, "page_cnt": {}, "bpm_size": {}, "shards": {}, )"
+               R"("replacer": "{}", "lru_k_size": {}, "bg_writer": {}, "scan_threads": {}, "get_threads": {}, )"
+               R"("zipf_theta": {}, "shift_ms": {}, "latency_us": {}, "queue_depth": {}, "bandwidth": {}}}, )",
+               workload, duration_ms, page_cnt, bpm_size, shards, replacer, LRU_K_SIZE, bg_writer, scan_threads,
+               get_threads, zipf_theta, shift_ms, latency_model.latency_.count(), latency_model.queue_depth_,
+               latency_model.bandwidth_);
+    fmt::print(R"("throughput": {{"scan": {}, "get": {}}}, )", total_metrics.ScanPerSec(), total_metrics.GetPerSec());
+    fmt::print(R"("fetch_latency": {{"scan": {}, "get": {}}}, )", total_metrics.scan_latency_.ToJson(),
+               total_metrics.get_latency_.ToJson());
+    fmt::print(R"("bpm": {}, "disk": {}}})"
+               "\n",
+               RowsToJson(bpm_rows), RowsToJson(disk_rows));
+  } else {
+    total_metrics.Report();
+  }
+  for (const auto &[name, value] : bpm_rows) {
+    fmt::print(stderr, "[metrics] bpm.{}: {}\n", name, value);
+  }
+  for (const auto &[name, value] : disk_rows) {
+    fmt::print(stderr, "[metrics] disk.{}: {}\n", name, value);
+  }
 
   return 0;
 }
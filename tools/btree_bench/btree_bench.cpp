@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -6,6 +7,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <cpp_random_distributions/zipfian_int_distribution.h>
@@ -32,12 +34,11 @@ auto ClockMs() -> uint64_t {
   return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
 }
 
-static const size_t BUSTUB_READ_THREAD = 4;
-static const size_t BUSTUB_WRITE_THREAD = 2;
 static const size_t LRU_K_SIZE = 4;
 static const size_t BUSTUB_BPM_SIZE = 256;
 static const size_t TOTAL_KEYS = 100000;
 static const size_t KEY_MODIFY_RANGE = 2048;
+static const size_t SCAN_PASSES = 5;
 
 struct BTreeTotalMetrics {
   uint64_t write_cnt_{0};
@@ -119,6 +120,8 @@ auto main(int argc, char **argv) -> int {
 
   argparse::ArgumentParser program("bustub-btree-bench");
   program.add_argument("--duration").help("run btree bench for n milliseconds");
+  program.add_argument("--read-threads").help("number of threads doing point lookups (default 4)");
+  program.add_argument("--write-threads").help("number of threads doing inserts and removes (default 2)");
 
   try {
     program.parse_args(argc, argv);
@@ -132,12 +135,21 @@ auto main(int argc, char **argv) -> int {
   if (program.present("--duration")) {
     duration_ms = std::stoi(program.get("--duration"));
   }
+  size_t read_threads = 4;
+  if (program.present("--read-threads")) {
+    read_threads = std::stoul(program.get("--read-threads"));
+  }
+  size_t write_threads = 2;
+  if (program.present("--write-threads")) {
+    write_threads = std::stoul(program.get("--write-threads"));
+  }
 
   auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
   auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
 
-  fmt::print(stderr, "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}\n", TOTAL_KEYS, duration_ms,
-             LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr, "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}, read_threads={}, ",
+             TOTAL_KEYS, duration_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE, read_threads);
+  fmt::print(stderr, "write_threads={}\n", write_threads);
 
   auto key_schema = bustub::ParseCreateStatement("a bigint");
   bustub::GenericComparator<8> comparator(key_schema.get());
@@ -157,6 +169,41 @@ auto main(int argc, char **argv) -> int {
     index.Insert(index_key, rid, nullptr);
   }
 
+  // Fan-out: how many entries a page holds, and the height and width of the tree that results.
+  using InternalPage = bustub::BPlusTreeInternalPage<bustub::GenericKey<8>, page_id_t, bustub::GenericComparator<8>>;
+  using LeafPage = bustub::BPlusTreeLeafPage<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+  size_t height = 1;
+  page_id_t node_id = index.GetRootPageId();
+  while (true) {
+    auto guard = bpm->FetchPageRead(node_id);
+    if (guard.As<bustub::BPlusTreePage>()->IsLeafPage()) {
+      break;
+    }
+    node_id = guard.As<InternalPage>()->ValueAt(0);
+    height++;
+  }
+  size_t leaf_pages = 0;
+  for (; node_id != bustub::INVALID_PAGE_ID; leaf_pages++) {
+    node_id = bpm->FetchPageRead(node_id).As<LeafPage>()->GetNextPageId();
+  }
+  fmt::print(stderr, "[info] page_size={}, leaf_max_size={}, internal_max_size={}, height={}, leaf_pages={}\n",
+             bustub::BUSTUB_PAGE_SIZE,
+             (bustub::BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<bustub::GenericKey<8>, bustub::RID>),
+             (bustub::BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<bustub::GenericKey<8>, page_id_t>),
+             height, leaf_pages);
+
+  // Scan throughput: full passes over the leaf level before the writers start.
+  auto scan_start = ClockMs();
+  size_t scanned = 0;
+  for (size_t pass = 0; pass < SCAN_PASSES; pass++) {
+    for (auto it = index.Begin(); !it.IsEnd(); ++it) {
+      scanned++;
+    }
+  }
+  auto scan_ms = std::max<uint64_t>(ClockMs() - scan_start, 1);
+  fmt::print(stderr, "[info] scan: {} keys in {} ms, {:.0f} keys/s\n", scanned, scan_ms,
+             scanned / static_cast<double>(scan_ms) * 1000);
+
   fmt::print(stderr, "[info] benchmark start\n");
 
   BTreeTotalMetrics total_metrics;
@@ -164,13 +211,13 @@ auto main(int argc, char **argv) -> int {
 
   std::vector<std::thread> threads;
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_READ_THREAD; thread_id++) {
-    threads.emplace_back([thread_id, &index, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < read_threads; thread_id++) {
+    threads.emplace_back([thread_id, read_threads, &index, duration_ms, &total_metrics] {
       BTreeMetrics metrics(fmt::format("read  {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t key_start = TOTAL_KEYS / BUSTUB_READ_THREAD * thread_id;
-      size_t key_end = TOTAL_KEYS / BUSTUB_READ_THREAD * (thread_id + 1);
+      size_t key_start = TOTAL_KEYS / read_threads * thread_id;
+      size_t key_end = TOTAL_KEYS / read_threads * (thread_id + 1);
       std::random_device r;
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
@@ -210,13 +257,13 @@ auto main(int argc, char **argv) -> int {
     });
   }
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_WRITE_THREAD; thread_id++) {
-    threads.emplace_back([thread_id, &index, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < write_threads; thread_id++) {
+    threads.emplace_back([thread_id, write_threads, &index, duration_ms, &total_metrics] {
       BTreeMetrics metrics(fmt::format("write {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t key_start = TOTAL_KEYS / BUSTUB_WRITE_THREAD * thread_id;
-      size_t key_end = TOTAL_KEYS / BUSTUB_WRITE_THREAD * (thread_id + 1);
+      size_t key_start = TOTAL_KEYS / write_threads * thread_id;
+      size_t key_end = TOTAL_KEYS / write_threads * (thread_id + 1);
       std::random_device r;
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
@@ -262,6 +309,12 @@ auto main(int argc, char **argv) -> int {
   }
 
   total_metrics.Report();
+  for (const auto &[name, value] : bpm->GetMetrics().ToRows()) {
+    fmt::print(stderr, "[metrics] bpm.{}: {}\n", name, value);
+  }
+  for (const auto &[name, value] : disk_manager->GetMetrics().ToRows()) {
+    fmt::print(stderr, "[metrics] disk.{}: {}\n", name, value);
+  }
 
   return 0;
 }